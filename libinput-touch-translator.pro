@@ -1,3 +1,4 @@
 TEMPLATE = subdirs
 SUBDIRS = src \
+    tests \
     touch-config
@@ -0,0 +1,91 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "deadline-timer.h"
+
+#include "event-reactor.h"
+
+#include <QTimer>
+
+DeadlineTimer::DeadlineTimer(std::function<void ()> callback)
+{
+    m_callback = callback;
+}
+
+DeadlineTimer::~DeadlineTimer()
+{
+    if (m_reactor)
+        m_reactor->destroyTimer(m_timer);
+
+    delete m_qtimer;
+}
+
+void DeadlineTimer::start(quint64 usec)
+{
+    // bind to the event loop at the first time, the recognizers are
+    // constructed before they are moved into the input thread.
+    if (!m_reactor && !m_qtimer) {
+        m_reactor = EventReactor::current();
+        if (m_reactor) {
+            m_timer = m_reactor->createTimer([=]() {
+                onTimeout();
+            });
+        } else {
+            m_qtimer = new QTimer;
+            m_qtimer->setSingleShot(true);
+            m_qtimer->setTimerType(Qt::PreciseTimer);
+            QObject::connect(m_qtimer, &QTimer::timeout, [=]() {
+                onTimeout();
+            });
+        }
+    }
+
+    m_isActive = true;
+    if (m_reactor) {
+        m_reactor->startTimer(m_timer, usec);
+    } else {
+        // round up, a deadline should never expire early.
+        m_qtimer->start(int((usec + 999) / 1000));
+    }
+}
+
+void DeadlineTimer::stop()
+{
+    if (!m_isActive)
+        return;
+
+    m_isActive = false;
+    if (m_reactor) {
+        m_reactor->stopTimer(m_timer);
+    } else if (m_qtimer) {
+        m_qtimer->stop();
+    }
+}
+
+void DeadlineTimer::onTimeout()
+{
+    if (!m_isActive)
+        return;
+
+    m_isActive = false;
+    m_callback();
+}
@@ -0,0 +1,63 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef DEADLINETIMER_H
+#define DEADLINETIMER_H
+
+#include <QtGlobal>
+
+#include <functional>
+
+class EventReactor;
+class QTimer;
+
+/*!
+ * \brief The DeadlineTimer class
+ * is a one-shot timer for gesture deadlines. It is backed by a timerfd of
+ * the reactor if it is started in the reactor thread, otherwise by a
+ * QTimer of the current event loop.
+ */
+class DeadlineTimer
+{
+public:
+    explicit DeadlineTimer(std::function<void ()> callback);
+    ~DeadlineTimer();
+
+    void start(quint64 usec);
+    void stop();
+
+    bool isActive() const {return m_isActive;}
+
+private:
+    void onTimeout();
+
+    std::function<void ()> m_callback;
+
+    EventReactor *m_reactor = nullptr;
+    int m_timer = -1;
+
+    QTimer *m_qtimer = nullptr;
+
+    bool m_isActive = false;
+};
+
+#endif // DEADLINETIMER_H
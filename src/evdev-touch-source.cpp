@@ -0,0 +1,437 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "evdev-touch-source.h"
+
+
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+
+#include <QDebug>
+
+#define EVENTS_PER_READ 64
+// a bound of the slots of a device, and the slots of a raw recording.
+#define EVDEV_MAX_SLOTS 256
+
+#define BITS_PER_LONG (sizeof(unsigned long) * 8)
+#define NLONGS(x) (((x) + BITS_PER_LONG - 1) / BITS_PER_LONG)
+
+static bool test_bit(const unsigned long *bits, int bit)
+{
+    return bits[bit / BITS_PER_LONG] & (1UL << (bit % BITS_PER_LONG));
+}
+
+EvdevTouchSource::EvdevTouchSource(EvdevTouchSource::FrameHandler handler)
+{
+    m_handler = handler;
+}
+
+EvdevTouchSource::~EvdevTouchSource()
+{
+    close();
+}
+
+bool EvdevTouchSource::open(const QString &path)
+{
+    close();
+
+    int fd = ::open(path.toLocal8Bit().constData(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        qErrnoWarning(errno, "can not open %s", qPrintable(path));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        ::close(fd);
+        return false;
+    }
+
+    m_fd = fd;
+    m_path = path;
+    m_name.clear();
+    m_isRecording = !S_ISCHR(st.st_mode);
+    m_isDropped = false;
+    m_currentSlot = 0;
+    m_slot = Axis();
+    m_x = Axis();
+    m_y = Axis();
+    m_major = Axis();
+    m_pressure = Axis();
+    m_decoder.reset();
+
+    if (m_isRecording) {
+        if (readRecordingHeader()) {
+            qDebug()<<"replay recorded evdev events from"<<path;
+        } else {
+            qWarning()<<path<<"has no axes, the positions are replayed in device units";
+            m_slot.maximum = EVDEV_MAX_SLOTS - 1;
+        }
+        setSlotCount(m_slot.maximum + 1);
+        return true;
+    }
+
+    unsigned long absbits[NLONGS(ABS_CNT)] = {0};
+    if (ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(absbits)), absbits) < 0 || !test_bit(absbits, ABS_MT_SLOT)) {
+        qWarning()<<path<<"is not a multitouch protocol-B device";
+        close();
+        return false;
+    }
+
+    char name[256] = {0};
+    if (ioctl(fd, EVIOCGNAME(sizeof(name) - 1), name) >= 0)
+        m_name = QString::fromLocal8Bit(name);
+
+    // use the same clock as libinput and the gesture deadlines.
+    int clock = CLOCK_MONOTONIC;
+    ioctl(fd, EVIOCSCLOCKID, &clock);
+
+    readAxis(ABS_MT_SLOT, m_slot);
+    setSlotCount(m_slot.maximum + 1);
+    readAxis(ABS_MT_POSITION_X, m_x);
+    readAxis(ABS_MT_POSITION_Y, m_y);
+    if (test_bit(absbits, ABS_MT_TOUCH_MAJOR))
+        readAxis(ABS_MT_TOUCH_MAJOR, m_major);
+    if (test_bit(absbits, ABS_MT_PRESSURE))
+        readAxis(ABS_MT_PRESSURE, m_pressure);
+
+    // pick up the fingers which are already on the screen.
+    resync();
+
+    return true;
+}
+
+void EvdevTouchSource::close()
+{
+    stopRecording();
+
+    if (m_fd < 0)
+        return;
+
+    ::close(m_fd);
+    m_fd = -1;
+}
+
+bool EvdevTouchSource::startRecording(const QString &path)
+{
+    if (m_fd < 0 || m_isRecording)
+        return false;
+
+    stopRecording();
+
+    int fd = ::open(path.toLocal8Bit().constData(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        qErrnoWarning(errno, "can not create %s", qPrintable(path));
+        return false;
+    }
+
+    EvdevRecordingHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, EVDEV_RECORDING_MAGIC, sizeof(header.magic));
+    header.version = EVDEV_RECORDING_VERSION;
+    const Axis *axes[] = {&m_slot, &m_x, &m_y, &m_major, &m_pressure};
+    for (int i = 0; i < EvdevRecordingHeader::AxisCount; i++) {
+        header.axes[i].minimum = axes[i]->minimum;
+        header.axes[i].maximum = axes[i]->maximum;
+        header.axes[i].resolution = axes[i]->resolution;
+    }
+
+    if (write(fd, &header, sizeof(header)) != (ssize_t)sizeof(header)) {
+        qErrnoWarning(errno, "can not write %s", qPrintable(path));
+        ::close(fd);
+        return false;
+    }
+
+    qDebug()<<"record evdev events of"<<m_path<<"to"<<path;
+    m_recordFd = fd;
+    return true;
+}
+
+void EvdevTouchSource::stopRecording()
+{
+    if (m_recordFd < 0)
+        return;
+
+    ::close(m_recordFd);
+    m_recordFd = -1;
+}
+
+void EvdevTouchSource::dispatch()
+{
+    struct input_event events[EVENTS_PER_READ];
+
+    while (m_fd >= 0) {
+        ssize_t len = read(m_fd, events, sizeof(events));
+        if (len < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN) {
+                qErrnoWarning(errno, "can not read %s", qPrintable(m_path));
+                close();
+            }
+            break;
+        }
+
+        if (len == 0) {
+            // end of the recording.
+            close();
+            break;
+        }
+
+        if (m_recordFd >= 0 && write(m_recordFd, events, len) != len) {
+            qErrnoWarning(errno, "stop recording %s", qPrintable(m_path));
+            stopRecording();
+        }
+
+        int count = len / sizeof(struct input_event);
+        for (int i = 0; i < count; i++) {
+            processEvent(events[i]);
+        }
+
+        // a short read means the kernel buffer is drained.
+        if (!m_isRecording && len < (ssize_t)sizeof(events))
+            break;
+    }
+}
+
+void EvdevTouchSource::setAxis(const struct input_absinfo &info, EvdevTouchSource::Axis &axis)
+{
+    axis.minimum = info.minimum;
+    axis.maximum = info.maximum;
+    // same as libinput, fake the resolution if the device doesn't have one.
+    axis.resolution = info.resolution > 0? info.resolution: 1;
+}
+
+void EvdevTouchSource::readAxis(int code, EvdevTouchSource::Axis &axis)
+{
+    struct input_absinfo info;
+    if (ioctl(m_fd, EVIOCGABS(code), &info) < 0)
+        return;
+
+    setAxis(info, axis);
+}
+
+bool EvdevTouchSource::readRecordingHeader()
+{
+    EvdevRecordingHeader header;
+    ssize_t len = read(m_fd, &header, sizeof(header));
+    if (len != (ssize_t)sizeof(header)
+            || memcmp(header.magic, EVDEV_RECORDING_MAGIC, sizeof(header.magic)) != 0
+            || header.version != EVDEV_RECORDING_VERSION) {
+        // a raw recording, the events start at the beginning.
+        lseek(m_fd, 0, SEEK_SET);
+        return false;
+    }
+
+    Axis *axes[] = {&m_slot, &m_x, &m_y, &m_major, &m_pressure};
+    for (int i = 0; i < EvdevRecordingHeader::AxisCount; i++) {
+        setAxis(header.axes[i], *axes[i]);
+    }
+    return true;
+}
+
+void EvdevTouchSource::setSlotCount(int count)
+{
+    count = qBound(1, count, EVDEV_MAX_SLOTS);
+    m_slots.fill(Slot(), count);
+    m_slotValues.resize(count + 1);
+}
+
+void EvdevTouchSource::processEvent(const struct input_event &event)
+{
+    quint64 time = quint64(event.input_event_sec) * 1000000 + event.input_event_usec;
+
+    if (m_isDropped) {
+        // drop all events until the next SYN_REPORT, then sync the slots.
+        if (event.type == EV_SYN && event.code == SYN_REPORT) {
+            m_isDropped = false;
+            resync();
+            sync(time);
+        }
+        return;
+    }
+
+    switch (event.type) {
+    case EV_ABS: {
+        if (event.code == ABS_MT_SLOT) {
+            m_currentSlot = event.value;
+            break;
+        }
+
+        // the slots are bound by the slot axis, nothing is out of it.
+        if (m_currentSlot < 0 || m_currentSlot >= m_slots.size())
+            break;
+
+        Slot &slot = m_slots[m_currentSlot];
+        switch (event.code) {
+        case ABS_MT_TRACKING_ID:
+            slot.trackingId = event.value;
+            break;
+        case ABS_MT_POSITION_X:
+            slot.x = event.value;
+            break;
+        case ABS_MT_POSITION_Y:
+            slot.y = event.value;
+            break;
+        case ABS_MT_TOUCH_MAJOR:
+            slot.major = event.value;
+            break;
+        case ABS_MT_PRESSURE:
+            slot.pressure = event.value;
+            break;
+        default:
+            return;
+        }
+        slot.isDirty = true;
+        break;
+    }
+    case EV_SYN: {
+        if (event.code == SYN_REPORT) {
+            sync(time);
+        } else if (event.code == SYN_DROPPED) {
+            m_isDropped = true;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void EvdevTouchSource::sync(quint64 time)
+{
+    bool changed = false;
+
+    for (int i = 0; i < m_slots.size(); i++) {
+        Slot &slot = m_slots[i];
+        if (!slot.isDirty)
+            continue;
+
+        slot.isDirty = false;
+        changed = true;
+
+        double x = toMM(m_x, slot.x);
+        double y = toMM(m_y, slot.y);
+        double nx = normalize(m_x, slot.x);
+        double ny = normalize(m_y, slot.y);
+        double major = toMM(m_major, slot.major);
+        double pressure = normalize(m_pressure, slot.pressure);
+
+        if (slot.isActive && slot.trackingId != slot.activeTrackingId) {
+            // released, or taken by a new contact without a release in
+            // between, e.g. after SYN_DROPPED. The new one is put down below.
+            slot.isActive = false;
+            slot.activeTrackingId = -1;
+            if (m_decoder.touchUp(i, time))
+                m_handler(m_decoder.frame());
+        }
+
+        if (!slot.isActive && slot.trackingId >= 0) {
+            slot.isActive = true;
+            slot.activeTrackingId = slot.trackingId;
+            if (m_decoder.touchDown(i, time, x, y, nx, ny, major, pressure))
+                m_handler(m_decoder.frame());
+        } else if (slot.isActive) {
+            if (m_decoder.touchMotion(i, time, x, y, nx, ny, major, pressure))
+                m_handler(m_decoder.frame());
+        }
+    }
+
+    if (changed && m_decoder.touchFrame(time))
+        m_handler(m_decoder.frame());
+}
+
+void EvdevTouchSource::resync()
+{
+    static const int codes[] = {ABS_MT_POSITION_X, ABS_MT_POSITION_Y, ABS_MT_TOUCH_MAJOR, ABS_MT_PRESSURE};
+
+    // the code and then the values of the slots, allocated by open().
+    __s32 *request = m_slotValues.data();
+    const __s32 *values = request + 1;
+    int size = m_slotValues.size() * sizeof(__s32);
+
+    memset(request, 0, size);
+    request[0] = ABS_MT_TRACKING_ID;
+    if (m_isRecording || ioctl(m_fd, EVIOCGMTSLOTS(size), request) < 0) {
+        // the state of slots is lost, cancel all the fingers.
+        struct timespec tp;
+        clock_gettime(CLOCK_MONOTONIC, &tp);
+        quint64 time = quint64(tp.tv_sec) * 1000000 + tp.tv_nsec / 1000;
+        for (int i = 0; i < m_slots.size(); i++) {
+            if (m_slots[i].isActive && m_decoder.touchCancel(i, time))
+                m_handler(m_decoder.frame());
+            m_slots[i] = Slot();
+        }
+        return;
+    }
+
+    for (int i = 0; i < m_slots.size(); i++) {
+        m_slots[i].trackingId = values[i];
+        m_slots[i].isDirty = true;
+    }
+
+    for (auto code : codes) {
+        memset(request, 0, size);
+        request[0] = code;
+        if (ioctl(m_fd, EVIOCGMTSLOTS(size), request) < 0)
+            continue;
+        for (int i = 0; i < m_slots.size(); i++) {
+            switch (code) {
+            case ABS_MT_POSITION_X:
+                m_slots[i].x = values[i];
+                break;
+            case ABS_MT_POSITION_Y:
+                m_slots[i].y = values[i];
+                break;
+            case ABS_MT_TOUCH_MAJOR:
+                m_slots[i].major = values[i];
+                break;
+            case ABS_MT_PRESSURE:
+                m_slots[i].pressure = values[i];
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    struct input_absinfo info;
+    if (ioctl(m_fd, EVIOCGABS(ABS_MT_SLOT), &info) == 0)
+        m_currentSlot = info.value;
+}
+
+double EvdevTouchSource::toMM(const EvdevTouchSource::Axis &axis, int value) const
+{
+    return double(value - axis.minimum) / axis.resolution;
+}
+
+double EvdevTouchSource::normalize(const EvdevTouchSource::Axis &axis, int value) const
+{
+    if (axis.maximum <= axis.minimum)
+        return 0;
+    return double(value - axis.minimum) / (axis.maximum - axis.minimum);
+}
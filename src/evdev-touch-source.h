@@ -0,0 +1,157 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef EVDEVTOUCHSOURCE_H
+#define EVDEVTOUCHSOURCE_H
+
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+#include <linux/input.h>
+
+#include "touch-screen/touch-frame.h"
+
+#define EVDEV_RECORDING_MAGIC "EVDEVREC"
+#define EVDEV_RECORDING_VERSION 1
+
+/*!
+ * \brief The EvdevRecordingHeader struct
+ * starts a recording, and keeps the axes of the recorded device, so the
+ * replay is scaled and sized like the device. The input_event follow it.
+ */
+struct EvdevRecordingHeader
+{
+    enum AxisIndex {
+        SlotAxis,
+        XAxis,
+        YAxis,
+        MajorAxis,
+        PressureAxis,
+        AxisCount
+    };
+
+    char magic[8];
+    __u32 version;
+    __u32 reserved;
+    struct input_absinfo axes[AxisCount];
+};
+
+/*!
+ * \brief The EvdevTouchSource class
+ * reads a multitouch protocol-B touch screen directly, without libinput.
+ * It reads the input_event in batch, tracks the ABS_MT slots itself, and
+ * reports the same TouchFrame as the libinput backend does, with the touch
+ * major and pressure which libinput doesn't provide.
+ *
+ * A regular file of recorded input_event can be opened too, it will be
+ * replayed at once by dispatch(). It is written by startRecording(), and
+ * starts with an EvdevRecordingHeader. A raw one (e.g. cat /dev/input/eventX
+ * > file) has no axes, and is replayed in device units instead of mm.
+ */
+class EvdevTouchSource
+{
+public:
+    typedef std::function<void (const TouchFrame &frame)> FrameHandler;
+
+    explicit EvdevTouchSource(FrameHandler handler);
+    ~EvdevTouchSource();
+
+    bool open(const QString &path);
+    void close();
+
+    int fd() const {return m_fd;}
+    QString path() const {return m_path;}
+    QString name() const {return m_name;}
+    bool isRecording() const {return m_isRecording;}
+
+    void setFilterProfile(const TouchPointFilter::Profile &profile) {m_decoder.setFilterProfile(profile);}
+
+    /*!
+     * \brief startRecording
+     * write the axes of the device and then all the events read from now on
+     * to the file, until the source is closed. A recording can't be recorded.
+     */
+    bool startRecording(const QString &path);
+
+    /*!
+     * \brief dispatch
+     * read all the available events, and report the frames.
+     */
+    void dispatch();
+
+private:
+    struct Axis {
+        int minimum = 0;
+        int maximum = 0;
+        int resolution = 1; // units per mm
+    };
+
+    struct Slot {
+        int trackingId = -1;
+        int activeTrackingId = -1; // of the contact reported to the decoder
+        int x = 0;
+        int y = 0;
+        int major = 0;
+        int pressure = 0;
+        bool isActive = false; // reported to the decoder as down
+        bool isDirty = false;
+    };
+
+    static void setAxis(const struct input_absinfo &info, Axis &axis);
+    void readAxis(int code, Axis &axis);
+    bool readRecordingHeader();
+    void setSlotCount(int count);
+    void stopRecording();
+    void processEvent(const struct input_event &event);
+    void sync(quint64 time);
+    void resync();
+
+    double toMM(const Axis &axis, int value) const;
+    double normalize(const Axis &axis, int value) const;
+
+    FrameHandler m_handler;
+    TouchFrameDecoder m_decoder;
+
+    int m_fd = -1;
+    QString m_path;
+    QString m_name;
+    bool m_isRecording = false;
+
+    int m_recordFd = -1;
+
+    bool m_isDropped = false;
+    int m_currentSlot = 0;
+    // sized by the slot axis, the decoder maps them to the frame table.
+    QVector<Slot> m_slots;
+    // the buffer of EVIOCGMTSLOTS, the code and a value of each slot.
+    QVector<__s32> m_slotValues;
+
+    Axis m_slot;
+    Axis m_x;
+    Axis m_y;
+    Axis m_major;
+    Axis m_pressure;
+};
+
+#endif // EVDEVTOUCHSOURCE_H
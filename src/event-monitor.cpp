@@ -21,17 +21,27 @@
  */
 
 #include "event-monitor.h"
+#include "event-reactor.h"
+#include "evdev-touch-source.h"
+#include "touch-device-manager.h"
+#include "settings-manager.h"
+#include "uinput-helper.h"
+#include "latency-tracker.h"
 
 #include "touch-screen/touch-screen-gesture-manager.h"
 #include "touchpad/touchpad-gesture-manager.h"
 
-#include <libudev.h>
 #include <linux/uinput.h>
 #include <fcntl.h>
 #include <unistd.h>
 
-#include <poll.h>
+#include <signal.h>
 
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QSocketNotifier>
 #include <QDebug>
 
 static int open_restricted(const char *path, int flags, void *user_data)
@@ -45,6 +55,10 @@ static void close_restricted(int fd, void *user_data)
     close(fd);
 }
 
+// every monitor, the control commands of the primary one apply to all seats.
+static QList<EventMonitor *> monitors;
+static QMutex monitors_mutex;
+
 const static struct libinput_interface interface = {
     .open_restricted = open_restricted,
     .close_restricted = close_restricted,
@@ -52,108 +66,515 @@ const static struct libinput_interface interface = {
 
 EventMonitor::EventMonitor(QObject *parent) : QObject(parent)
 {
-    struct libinput *li;
-    struct libinput_event *event;
+    m_deviceManager = new TouchDeviceManager(this);
+    connect(m_deviceManager, &TouchDeviceManager::deviceAdded, this, &EventMonitor::onDeviceAdded);
+    connect(m_deviceManager, &TouchDeviceManager::deviceRemoved, this, &EventMonitor::onDeviceRemoved);
+
+    // a path context, only the touch devices reported by the device manager
+    // are added, instead of every input device of the seat.
+    m_input = libinput_path_create_context(static_cast<const libinput_interface*>(&interface), NULL);
+
+    QMutexLocker locker(&monitors_mutex);
+    monitors<<this;
+}
+
+EventMonitor::~EventMonitor()
+{
+    {
+        QMutexLocker locker(&monitors_mutex);
+        monitors.removeOne(this);
+    }
+
+    qDeleteAll(m_evdevSources);
+    qDeleteAll(m_evdevManagers);
+    qDeleteAll(m_touchScreenManagers);
+
+    for (auto device : m_devices)
+        libinput_device_unref(device);
+
+    if (m_input)
+        libinput_unref(m_input);
+}
 
-    udev *dev = udev_new();
-    li = libinput_udev_create_context(static_cast<const libinput_interface*>(&interface), NULL, dev);
-    if (!li)
+void EventMonitor::startMonitor()
+{
+    if (!m_input)
         return;
-    libinput_udev_assign_seat(li, "seat0");
-    libinput_dispatch(li);
 
-    bool successed = false;
+    if (m_realtimeProfile.isEnabled())
+        m_realtimeProfile.applyToCurrentThread();
+
+    EventReactor reactor;
+    if (!reactor.isValid())
+        return;
+
+    {
+        // stopMonitor() might be called by another thread.
+        QMutexLocker locker(&m_reactorMutex);
+        if (m_isStopping)
+            return;
+        // m_isSuspended given by setSuspended() meanwhile is honored by
+        // startDevices() below.
+        m_isStarted = true;
+        m_reactor = &reactor;
+    }
+
+    watchFd(libinput_get_fd(m_input), [=]() {
+        dispatchEvents();
+    });
+
+    // the process wide sources are handled by the primary monitor only.
+    if (m_isPrimary) {
+        reactor.watchSignals(QList<int>()<<SIGTERM<<SIGHUP<<SIGUSR1, [=](int signo) {
+            handleSignal(signo);
+        });
+
+        reactor.watchFile(SettingsManager::getManager()->fileName(), []() {
+            SettingsManager::getManager()->reload();
+        });
+    }
+
+    if (!m_controlSocketPath.isEmpty()) {
+        reactor.listenControlSocket(m_controlSocketPath, [=](const QByteArray &command) {
+            return handleControlCommand(command);
+        });
+    }
+
+    startDevices();
+
+    reactor.run();
+
+    // the timers of recognizers belong to the reactor, free them before it.
+    qDeleteAll(m_touchScreenManagers);
+    m_touchScreenManagers.clear();
+    while (!m_evdevSources.isEmpty())
+        closeEvdevSource(m_evdevSources.first());
+
+    QMutexLocker locker(&m_reactorMutex);
+    m_reactor = nullptr;
+}
+
+void EventMonitor::stopMonitor()
+{
+    QMutexLocker locker(&m_reactorMutex);
+    m_isStopping = true;
+    if (m_reactor)
+        m_reactor->stop();
+}
+
+void EventMonitor::startNotifier()
+{
+    if (!m_input || !m_notifiers.isEmpty())
+        return;
+
+    if (m_realtimeProfile.isEnabled())
+        m_realtimeProfile.applyToCurrentThread();
+
+    {
+        QMutexLocker locker(&m_reactorMutex);
+        m_isStarted = true;
+    }
+
+    watchFd(libinput_get_fd(m_input), [=]() {
+        dispatchEvents();
+    });
+
+    startDevices();
+}
+
+void EventMonitor::startDevices()
+{
+    // created in the thread of monitor, the gestures are executed here.
+    m_output = new UInputHelper(m_deviceManager->seat(), this);
+    m_touchpadManager = new TouchpadGestureManager(m_output, this);
+
+    // the given devices or recordings replace the hotplugged touch screens.
+    if (m_backend == EvdevBackend && !m_isSuspended) {
+        for (auto device : m_evdevDevices)
+            openEvdevSource(device);
+    }
+
+    if (m_deviceManager->start()) {
+        watchFd(m_deviceManager->fd(), [=]() {
+            m_deviceManager->dispatch();
+        });
+    }
+
+    // the device added events are queued by libinput_path_add_device().
+    dispatchEvents();
+}
+
+void EventMonitor::watchFd(int fd, std::function<void ()> handler)
+{
+    if (m_reactor) {
+        m_reactor->addFd(fd, [=](quint32) {
+            handler();
+        });
+        return;
+    }
+
+    auto notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+    connect(notifier, &QSocketNotifier::activated, this, handler);
+    m_notifiers.insert(fd, notifier);
+}
+
+void EventMonitor::unwatchFd(int fd)
+{
+    if (m_reactor) {
+        m_reactor->removeFd(fd);
+        return;
+    }
+
+    // it might be called from the activated signal of the notifier.
+    auto notifier = m_notifiers.take(fd);
+    if (notifier) {
+        notifier->setEnabled(false);
+        notifier->deleteLater();
+    }
+}
+
+void EventMonitor::onDeviceAdded(const QString &devnode, TouchDeviceManager::DeviceType type)
+{
+    // it will be added when resumed.
+    if (m_isSuspended)
+        return;
+
+    addDevice(devnode, type);
+}
+
+void EventMonitor::onDeviceRemoved(const QString &devnode, TouchDeviceManager::DeviceType type)
+{
+    Q_UNUSED(type)
+
+    removeDevice(devnode);
+}
+
+void EventMonitor::addDevice(const QString &devnode, TouchDeviceManager::DeviceType type)
+{
+    if (type == TouchDeviceManager::TouchScreen && m_backend == EvdevBackend) {
+        if (m_evdevDevices.isEmpty())
+            openEvdevSource(devnode);
+        return;
+    }
+
+    libinput_device *device = libinput_path_add_device(m_input, devnode.toLocal8Bit().constData());
+    if (!device) {
+        qWarning()<<"libinput can not add"<<devnode;
+        return;
+    }
+    m_devices.insert(devnode, libinput_device_ref(device));
+}
+
+void EventMonitor::removeDevice(const QString &devnode)
+{
+    auto source = findEvdevSource(devnode);
+    if (source)
+        closeEvdevSource(source);
+
+    libinput_device *device = m_devices.take(devnode);
+    if (device) {
+        libinput_path_remove_device(device);
+        libinput_device_unref(device);
+        // the touch sequences are cancelled by libinput.
+        dispatchEvents();
+    }
+}
+
+void EventMonitor::dispatchEvents()
+{
+    struct libinput *li = m_input;
+    struct libinput_event *event;
+
+    libinput_dispatch(li);
     while ((event = libinput_get_event(li)) != NULL) {
+
+        // handle the event here
         auto type = libinput_event_get_type(event);
+        //printf("loop\n");
+
         switch (type) {
+        case LIBINPUT_EVENT_TOUCH_DOWN:
+        case LIBINPUT_EVENT_TOUCH_MOTION:
+        case LIBINPUT_EVENT_TOUCH_UP:
+        case LIBINPUT_EVENT_TOUCH_FRAME:
+        case LIBINPUT_EVENT_TOUCH_CANCEL: {
+            //printf("touch event %d\n", type);
+            // every touch screen has its own recognizers.
+            auto manager = m_touchScreenManagers.value(libinput_event_get_device(event));
+            if (manager) {
+                manager->processEvent(event);
+            }
+            break;
+        }
+
+        case LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN:
+        case LIBINPUT_EVENT_GESTURE_SWIPE_UPDATE:
+        case LIBINPUT_EVENT_GESTURE_SWIPE_END:
+        case LIBINPUT_EVENT_GESTURE_PINCH_BEGIN:
+        case LIBINPUT_EVENT_GESTURE_PINCH_UPDATE:
+        case LIBINPUT_EVENT_GESTURE_PINCH_END:
+#ifdef HAVE_LIBINPUT_HOLD_GESTURES
+        case LIBINPUT_EVENT_GESTURE_HOLD_BEGIN:
+        case LIBINPUT_EVENT_GESTURE_HOLD_END:
+#endif
+        {
+            m_touchpadManager->processEvent(event);
+            break;
+        }
         case LIBINPUT_EVENT_DEVICE_ADDED: {
             libinput_device *dev = libinput_event_get_device(event);
-            const char *name = libinput_device_get_name(dev);
-            printf("%s added\n", name);
+            printf("%s added\n", libinput_device_get_name(dev));
             libinput_device_config_send_events_set_mode(dev, LIBINPUT_CONFIG_SEND_EVENTS_ENABLED);
             if (libinput_device_has_capability(dev, LIBINPUT_DEVICE_CAP_TOUCH)) {
-                printf("has cap touch\n");
-                libinput_device_ref(dev);
-                // config device?
+                auto manager = createTouchScreenManager(libinput_device_get_sysname(dev));
+                manager->setFilterProfile(SettingsManager::getManager()->touchFilterProfile(libinput_device_get_name(dev)));
+                m_touchScreenManagers.insert(dev, manager);
             }
             break;
         }
+        case LIBINPUT_EVENT_DEVICE_REMOVED: {
+            libinput_device *dev = libinput_event_get_device(event);
+            printf("%s removed\n", libinput_device_get_name(dev));
+            // the pending touches are cancelled before the device is removed.
+            delete m_touchScreenManagers.take(dev);
+            break;
+        }
         default:
-            printf("other event %d\n", type);
+            //printf("other event %d\n", type);
             break;
         }
         libinput_event_destroy(event);
         libinput_dispatch(li);
-
-        successed = true;
     }
+}
 
-    if (!successed)
-        fprintf(stderr, "can not get devices, maybe permission problem.\n");
+TouchScreenGestureManager *EventMonitor::createTouchScreenManager(const QString &deviceName)
+{
+    auto manager = new TouchScreenGestureManager(deviceName, m_output, this);
+    manager->createGestures();
+    return manager;
+}
 
-    m_input = li;
+void EventMonitor::setSeat(const QString &seat)
+{
+    m_deviceManager->setSeat(seat);
 }
 
-void EventMonitor::startMonitor()
+QString EventMonitor::seat() const
 {
-    struct libinput *li = m_input;
-    struct libinput_event *event;
+    return m_deviceManager->seat();
+}
+
+void EventMonitor::setPrimary(bool isPrimary)
+{
+    m_isPrimary = isPrimary;
+}
 
-    struct pollfd fds;
-
-    fds.fd = libinput_get_fd(li);
-    fds.events = POLLIN;
-    fds.revents = 0;
-    /* time offset starts with our first received event */
-    if (poll(&fds, 1, -1) > -1) {
-        struct timespec tp;
-
-        clock_gettime(CLOCK_MONOTONIC, &tp);
-        //start_time = tp.tv_sec * 1000 + tp.tv_nsec / 1000000;
-        do {
-            libinput_dispatch(li);
-            while ((event = libinput_get_event(li)) != NULL) {
-
-                // handle the event here
-                auto type = libinput_event_get_type(event);
-                //printf("loop\n");
-
-                switch (type) {
-                case LIBINPUT_EVENT_TOUCH_DOWN:
-                case LIBINPUT_EVENT_TOUCH_MOTION:
-                case LIBINPUT_EVENT_TOUCH_UP:
-                case LIBINPUT_EVENT_TOUCH_FRAME:
-                case LIBINPUT_EVENT_TOUCH_CANCEL: {
-                    //printf("touch event %d\n", type);
-                    if (m_touchScreenGestureManager) {
-                        m_touchScreenGestureManager->processEvent(event);
-                    }
-                    break;
-                }
-
-                case LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN:
-                case LIBINPUT_EVENT_GESTURE_SWIPE_UPDATE:
-                case LIBINPUT_EVENT_GESTURE_SWIPE_END:
-                case LIBINPUT_EVENT_GESTURE_PINCH_BEGIN:
-                case LIBINPUT_EVENT_GESTURE_PINCH_UPDATE:
-                case LIBINPUT_EVENT_GESTURE_PINCH_END: {
-                    TouchpadGestureManager::getManager()->processEvent(event);
-                    break;
-                }
-                default:
-                    //printf("other event %d\n", type);
-                    break;
-                }
-                libinput_event_destroy(event);
-                libinput_dispatch(li);
+void EventMonitor::setSuspended(bool suspended)
+{
+    {
+        QMutexLocker locker(&m_reactorMutex);
+        if (m_reactor) {
+            m_reactor->post([=]() {
+                applySuspended(suspended);
+            });
+            return;
+        }
+
+        // not started yet, its thread might be blocked in the reactor
+        // before it is published, so the state is picked up by start.
+        if (!m_isStarted) {
+            m_isSuspended = suspended;
+            return;
+        }
+
+        // the reactor has been stopped, nothing to suspend.
+        if (m_isStopping)
+            return;
+    }
+
+    // without reactor, the monitor lives in main thread.
+    applySuspended(suspended);
+}
+
+void EventMonitor::applySuspended(bool suspended)
+{
+    if (suspended == m_isSuspended)
+        return;
+
+    m_isSuspended = suspended;
+    qInfo()<<m_deviceManager->seat()<<(suspended? "suspended": "resumed");
+
+    if (suspended) {
+        // like libinput_suspend(), but the devices are removed one by one,
+        // so the devices plugged or unplugged meanwhile are known when resumed.
+        for (auto devnode : m_deviceManager->devices())
+            removeDevice(devnode);
+
+        // the recordings are not watched, they have been replayed.
+        for (auto source : QList<EvdevTouchSource *>(m_evdevSources)) {
+            if (!source->isRecording())
+                closeEvdevSource(source);
+        }
+
+        if (m_touchpadManager)
+            m_touchpadManager->reset();
+    } else {
+        if (m_backend == EvdevBackend) {
+            for (auto device : m_evdevDevices) {
+                if (!findEvdevSource(device))
+                    openEvdevSource(device);
             }
-        } while (/*!stop && */poll(&fds, 1, -1) > -1);
+        }
+
+        for (auto devnode : m_deviceManager->devices())
+            addDevice(devnode, m_deviceManager->deviceType(devnode));
+    }
+
+    // the device added or removed events.
+    dispatchEvents();
+}
+
+void EventMonitor::setRealtimeProfile(const RealtimeProfile &profile)
+{
+    m_realtimeProfile = profile;
+}
+
+void EventMonitor::setControlSocketPath(const QString &path)
+{
+    m_controlSocketPath = path;
+}
+
+void EventMonitor::setBackend(EventMonitor::Backend backend, const QStringList &devices)
+{
+    m_backend = backend;
+    m_evdevDevices = devices;
+}
+
+void EventMonitor::setEvdevRecordDirectory(const QString &directory)
+{
+    m_evdevRecordDirectory = directory;
+}
+
+void EventMonitor::openEvdevSource(const QString &path)
+{
+    auto manager = createTouchScreenManager(path);
+    auto source = new EvdevTouchSource([=](const TouchFrame &frame) {
+        manager->processFrame(frame);
+    });
+    if (!source->open(path)) {
+        delete source;
+        delete manager;
+        return;
+    }
+    qDebug()<<"evdev touch screen"<<path<<"opened";
+    source->setFilterProfile(SettingsManager::getManager()->touchFilterProfile(source->name()));
+    if (!m_evdevRecordDirectory.isEmpty() && !source->isRecording()) {
+        auto fileName = QString("%1-%2.evdev").arg(QFileInfo(path).fileName())
+                .arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss"));
+        source->startRecording(QDir(m_evdevRecordDirectory).filePath(fileName));
     }
+    m_evdevSources<<source;
+    m_evdevManagers.insert(source, manager);
 
-    libinput_unref(li);
+    if (source->isRecording()) {
+        // replay it when the reactor is running, gestures need its timers.
+        if (m_reactor) {
+            m_reactor->post([=]() {
+                source->dispatch();
+            });
+        } else {
+            source->dispatch();
+        }
+        return;
+    }
+
+    int fd = source->fd();
+    watchFd(fd, [=]() {
+        source->dispatch();
+        // the device is unplugged, and the source closed its fd.
+        if (source->fd() < 0) {
+            unwatchFd(fd);
+            closeEvdevSource(source);
+        }
+    });
 }
 
-void EventMonitor::initTouchScreenGestureManager(TouchScreenGestureManager *manager)
+EvdevTouchSource *EventMonitor::findEvdevSource(const QString &path)
 {
-    m_touchScreenGestureManager = manager;
+    for (auto source : m_evdevSources) {
+        if (source->path() == path)
+            return source;
+    }
+    return nullptr;
+}
+
+void EventMonitor::closeEvdevSource(EvdevTouchSource *source)
+{
+    if (!m_evdevSources.removeOne(source))
+        return;
+
+    if (source->fd() >= 0)
+        unwatchFd(source->fd());
+    delete source;
+    delete m_evdevManagers.take(source);
+}
+
+void EventMonitor::handleSignal(int signo)
+{
+    switch (signo) {
+    case SIGHUP:
+        SettingsManager::getManager()->reload();
+        break;
+    case SIGUSR1:
+        qInfo().noquote()<<LatencyTracker::getTracker()->dump();
+        break;
+    case SIGTERM:
+        m_reactor->stop();
+        QMetaObject::invokeMethod(QCoreApplication::instance(), "quit", Qt::QueuedConnection);
+        break;
+    default:
+        break;
+    }
+}
+
+QByteArray EventMonitor::handleControlCommand(const QByteArray &command)
+{
+    if (command == "reload") {
+        SettingsManager::getManager()->reload();
+        return "ok";
+    }
+
+    if (command == "reset") {
+        for (auto manager : m_touchScreenManagers)
+            manager->forceReset();
+        for (auto manager : m_evdevManagers)
+            manager->forceReset();
+        if (m_touchpadManager)
+            m_touchpadManager->reset();
+        return "ok";
+    }
+
+    if (command == "suspend" || command == "resume") {
+        // posted to the reactor of each seat, this one included.
+        QMutexLocker locker(&monitors_mutex);
+        for (auto monitor : monitors)
+            monitor->setSuspended(command == "suspend");
+        return "ok";
+    }
+
+    if (command == "latency") {
+        return LatencyTracker::getTracker()->dump().toUtf8();
+    }
+
+    if (command == "latency reset") {
+        LatencyTracker::getTracker()->reset();
+        return "ok";
+    }
+
+    if (command == "realtime") {
+        return m_realtimeProfile.status().toUtf8();
+    }
+
+    return "unknown command: " + command;
 }
@@ -24,10 +24,23 @@
 #define EVENTMONITOR_H
 
 #include <QObject>
+#include <QStringList>
+#include <QHash>
+#include <QMutex>
+
+#include <functional>
 
 #include <libinput.h>
 
+#include "touch-device-manager.h"
+#include "realtime-profile.h"
+
+class QSocketNotifier;
+class EventReactor;
+class EvdevTouchSource;
 class TouchScreenGestureManager;
+class TouchpadGestureManager;
+class UInputHelper;
 
 class EventMonitor : public QObject
 {
@@ -40,21 +53,148 @@ public:
     };
     Q_ENUM(ActionType)
 
+    enum Backend {
+        LibinputBackend,
+        EvdevBackend // touch screens are read directly, touchpads still use libinput.
+    };
+    Q_ENUM(Backend)
+
     explicit EventMonitor(QObject *parent = nullptr);
+    ~EventMonitor();
 
 public slots:
+    /*!
+     * \brief startMonitor
+     * run an epoll reactor which multiplexes libinput, gesture deadlines,
+     * SIGTERM/SIGHUP, settings file changes and the control socket.
+     * It blocks until SIGTERM, run it in a dedicated thread.
+     */
     void startMonitor();
 
-    void initTouchScreenGestureManager(TouchScreenGestureManager *manager);
+    /*!
+     * \brief startNotifier
+     * watch the libinput fd from the event loop of current thread, so
+     * the events are recognized and translated without leaving the thread
+     * which owns the gesture manager.
+     */
+    void startNotifier();
+
+    /*!
+     * \brief stopMonitor
+     * stop the reactor of startMonitor(), it can be called from any thread.
+     */
+    void stopMonitor();
+
+    /*!
+     * \brief setSeat
+     * only the touch devices of the seat are opened, and the gestures are
+     * translated to a virtual device of the seat.
+     */
+    void setSeat(const QString &seat);
+    QString seat() const;
+
+    /*!
+     * \brief setPrimary
+     * the primary monitor handles the process wide sources, SIGTERM, SIGHUP
+     * and the settings file. It is true by default.
+     */
+    void setPrimary(bool isPrimary);
+
+    /*!
+     * \brief setRealtimeProfile
+     * the profile is applied to the thread which runs startMonitor() or
+     * startNotifier().
+     */
+    void setRealtimeProfile(const RealtimeProfile &profile);
+
+    /*!
+     * \brief setSuspended
+     * close all the touch devices of the seat when suspended, so nothing
+     * wakes the monitor up, and open them again when resumed. The hotplug
+     * is still followed meanwhile. It can be called from any thread.
+     */
+    void setSuspended(bool suspended);
+
+    void setControlSocketPath(const QString &path);
+
+    /*!
+     * \brief setBackend
+     * \param devices the device nodes or recordings for evdev backend,
+     * all touch screens, including the hotplugged ones, will be opened if
+     * it is empty.
+     */
+    void setBackend(Backend backend, const QStringList &devices = QStringList());
+
+    /*!
+     * \brief setEvdevRecordDirectory
+     * record the events of every evdev touch screen opened from now on into
+     * the directory, a file for each time it is opened.
+     */
+    void setEvdevRecordDirectory(const QString &directory);
 
 signals:
     void touchscreenGestureRequest(int fingerCount, ActionType type);
     void touchpadGestureRequest(int fingerCount, ActionType type);
 
+private slots:
+    void dispatchEvents();
+
+    void onDeviceAdded(const QString &devnode, TouchDeviceManager::DeviceType type);
+    void onDeviceRemoved(const QString &devnode, TouchDeviceManager::DeviceType type);
+
+    void applySuspended(bool suspended);
+
 private:
-    libinput *m_input;
+    void addDevice(const QString &devnode, TouchDeviceManager::DeviceType type);
+    void removeDevice(const QString &devnode);
+
+    void startDevices();
+
+    /*!
+     * \brief watchFd
+     * call the handler when fd is readable, with the reactor if it is
+     * running, otherwise with a QSocketNotifier.
+     */
+    void watchFd(int fd, std::function<void ()> handler);
+    void unwatchFd(int fd);
+
+    TouchScreenGestureManager *createTouchScreenManager(const QString &deviceName);
+
+    void openEvdevSource(const QString &path);
+    void closeEvdevSource(EvdevTouchSource *source);
+    EvdevTouchSource *findEvdevSource(const QString &path);
+
+    void handleSignal(int signo);
+    QByteArray handleControlCommand(const QByteArray &command);
+
+    libinput *m_input = nullptr;
+    QHash<QString, libinput_device *> m_devices;
+    TouchDeviceManager *m_deviceManager = nullptr;
+
+    UInputHelper *m_output = nullptr;
+    TouchpadGestureManager *m_touchpadManager = nullptr;
+
+    QHash<int, QSocketNotifier *> m_notifiers;
+
+    EventReactor *m_reactor = nullptr;
+    QMutex m_reactorMutex;
+    bool m_isStopping = false;
+    bool m_isStarted = false;
+    bool m_isPrimary = true;
+
+    RealtimeProfile m_realtimeProfile;
+
+    bool m_isSuspended = false;
+    QString m_controlSocketPath;
+
+    Backend m_backend = LibinputBackend;
+    QStringList m_evdevDevices;
+    QString m_evdevRecordDirectory;
+    QList<EvdevTouchSource *> m_evdevSources;
 
-    TouchScreenGestureManager *m_touchScreenGestureManager = nullptr;
+    // the recognizers of each touch screen.
+    QHash<libinput_device *, TouchScreenGestureManager *> m_touchScreenManagers;
+    QHash<EvdevTouchSource *, TouchScreenGestureManager *> m_evdevManagers;
 };
 
 #endif // EVENTMONITOR_H
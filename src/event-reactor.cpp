@@ -0,0 +1,455 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "event-reactor.h"
+
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QDebug>
+
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <sys/signalfd.h>
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#define MAX_EVENTS_PER_WAKEUP 32
+#define MAX_CONTROL_COMMAND_SIZE 4096
+#define MAX_CONTROL_REPLY_SIZE (256 * 1024)
+
+static thread_local EventReactor *current_reactor = nullptr;
+
+EventReactor::EventReactor()
+{
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epollFd < 0) {
+        qErrnoWarning(errno, "can not create epoll instance");
+        return;
+    }
+
+    m_wakeupFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_wakeupFd < 0) {
+        qErrnoWarning(errno, "can not create eventfd");
+        return;
+    }
+    addFd(m_wakeupFd, [=](quint32) {
+        onWakeup();
+    });
+}
+
+EventReactor::~EventReactor()
+{
+    for (auto fd : m_controlBuffers.keys()) {
+        close(fd);
+    }
+    if (m_controlFd >= 0) {
+        close(m_controlFd);
+        unlink(m_controlSocketPath.toLocal8Bit().constData());
+    }
+
+    if (m_inotifyFd >= 0)
+        close(m_inotifyFd);
+    if (m_signalFd >= 0)
+        close(m_signalFd);
+    if (m_wakeupFd >= 0)
+        close(m_wakeupFd);
+    if (m_epollFd >= 0)
+        close(m_epollFd);
+}
+
+EventReactor *EventReactor::current()
+{
+    return current_reactor;
+}
+
+bool EventReactor::blockSignals(const QList<int> &signalList)
+{
+    sigset_t mask;
+    sigemptyset(&mask);
+    for (auto signo : signalList) {
+        sigaddset(&mask, signo);
+    }
+    return pthread_sigmask(SIG_BLOCK, &mask, nullptr) == 0;
+}
+
+bool EventReactor::addFd(int fd, EventReactor::FdHandler handler, quint32 events)
+{
+    if (!isValid() || fd < 0)
+        return false;
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.fd = fd;
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        qErrnoWarning(errno, "can not add fd %d into epoll", fd);
+        return false;
+    }
+
+    m_handlers.insert(fd, handler);
+    return true;
+}
+
+void EventReactor::removeFd(int fd)
+{
+    if (!m_handlers.contains(fd))
+        return;
+
+    epoll_ctl(m_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    m_handlers.remove(fd);
+}
+
+int EventReactor::createTimer(EventReactor::Task task)
+{
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0) {
+        qErrnoWarning(errno, "can not create timerfd");
+        return -1;
+    }
+
+    bool added = addFd(fd, [=](quint32) {
+        quint64 expirations = 0;
+        if (read(fd, &expirations, sizeof(expirations)) != sizeof(expirations))
+            return;
+        task();
+    });
+
+    if (!added) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+void EventReactor::startTimer(int timer, quint64 usec)
+{
+    if (timer < 0)
+        return;
+
+    // a zero it_value disarms the timer, so expire as soon as possible instead.
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.it_value.tv_sec = usec / 1000000;
+    spec.it_value.tv_nsec = usec % 1000000 * 1000;
+    if (usec == 0)
+        spec.it_value.tv_nsec = 1;
+
+    timerfd_settime(timer, 0, &spec, nullptr);
+}
+
+void EventReactor::stopTimer(int timer)
+{
+    if (timer < 0)
+        return;
+
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    timerfd_settime(timer, 0, &spec, nullptr);
+}
+
+void EventReactor::destroyTimer(int timer)
+{
+    if (timer < 0)
+        return;
+
+    removeFd(timer);
+    close(timer);
+}
+
+bool EventReactor::watchSignals(const QList<int> &signalList, EventReactor::SignalHandler handler)
+{
+    if (m_signalFd >= 0)
+        return false;
+
+    sigset_t mask;
+    sigemptyset(&mask);
+    for (auto signo : signalList) {
+        sigaddset(&mask, signo);
+    }
+
+    // make sure the signals are not delivered to current thread.
+    pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+
+    m_signalFd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (m_signalFd < 0) {
+        qErrnoWarning(errno, "can not create signalfd");
+        return false;
+    }
+
+    return addFd(m_signalFd, [=](quint32) {
+        struct signalfd_siginfo info;
+        while (read(m_signalFd, &info, sizeof(info)) == sizeof(info)) {
+            handler(info.ssi_signo);
+        }
+    });
+}
+
+bool EventReactor::watchFile(const QString &path, EventReactor::Task task)
+{
+    if (m_inotifyFd >= 0)
+        return false;
+
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFd < 0) {
+        qErrnoWarning(errno, "can not create inotify instance");
+        return false;
+    }
+
+    // watch the directory, the file is usually replaced rather than
+    // rewritten by QSettings and editors.
+    QFileInfo info(path);
+    m_watchedFileName = info.fileName();
+    if (inotify_add_watch(m_inotifyFd, info.absolutePath().toLocal8Bit().constData(),
+                          IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+        qErrnoWarning(errno, "can not watch %s", qPrintable(path));
+        close(m_inotifyFd);
+        m_inotifyFd = -1;
+        return false;
+    }
+
+    return addFd(m_inotifyFd, [=](quint32) {
+        char buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+        bool changed = false;
+        ssize_t len;
+        while ((len = read(m_inotifyFd, buffer, sizeof(buffer))) > 0) {
+            for (char *ptr = buffer; ptr < buffer + len; ) {
+                auto event = reinterpret_cast<const struct inotify_event *>(ptr);
+                if (event->len > 0 && m_watchedFileName == QString::fromLocal8Bit(event->name))
+                    changed = true;
+                ptr += sizeof(struct inotify_event) + event->len;
+            }
+        }
+
+        // coalesce the changes of one wakeup.
+        if (changed)
+            task();
+    });
+}
+
+bool EventReactor::listenControlSocket(const QString &path, EventReactor::ControlHandler handler)
+{
+    if (m_controlFd >= 0)
+        return false;
+
+    QByteArray localPath = path.toLocal8Bit();
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (localPath.size() >= (int)sizeof(addr.sun_path)) {
+        qWarning()<<"control socket path is too long:"<<path;
+        return false;
+    }
+    strncpy(addr.sun_path, localPath.constData(), sizeof(addr.sun_path) - 1);
+
+    m_controlFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_controlFd < 0) {
+        qErrnoWarning(errno, "can not create control socket");
+        return false;
+    }
+
+    unlink(addr.sun_path);
+    if (bind(m_controlFd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0 || listen(m_controlFd, 4) < 0) {
+        qErrnoWarning(errno, "can not listen on %s", localPath.constData());
+        close(m_controlFd);
+        m_controlFd = -1;
+        return false;
+    }
+    // only root is allowed to control the daemon.
+    chmod(addr.sun_path, S_IRUSR | S_IWUSR);
+
+    m_controlSocketPath = path;
+    m_controlHandler = handler;
+
+    return addFd(m_controlFd, [=](quint32) {
+        onControlConnection();
+    });
+}
+
+void EventReactor::post(EventReactor::Task task)
+{
+    {
+        QMutexLocker locker(&m_postedTasksMutex);
+        m_postedTasks<<task;
+    }
+
+    quint64 value = 1;
+    if (write(m_wakeupFd, &value, sizeof(value)) < 0) {
+        qErrnoWarning(errno, "can not wake up reactor");
+    }
+}
+
+void EventReactor::run()
+{
+    if (!isValid())
+        return;
+
+    current_reactor = this;
+
+    struct epoll_event events[MAX_EVENTS_PER_WAKEUP];
+    while (m_running.loadAcquire()) {
+        int count = epoll_wait(m_epollFd, events, MAX_EVENTS_PER_WAKEUP, -1);
+        if (count < 0) {
+            if (errno == EINTR)
+                continue;
+            qErrnoWarning(errno, "epoll_wait failed");
+            break;
+        }
+
+        // handle all ready sources of this wakeup in one batch, a handler
+        // might remove other sources, so look them up every time.
+        for (int i = 0; i < count; i++) {
+            auto it = m_handlers.constFind(events[i].data.fd);
+            if (it == m_handlers.constEnd())
+                continue;
+            FdHandler handler = it.value();
+            handler(events[i].events);
+        }
+    }
+
+    current_reactor = nullptr;
+}
+
+void EventReactor::stop()
+{
+    m_running.storeRelease(0);
+
+    quint64 value = 1;
+    if (write(m_wakeupFd, &value, sizeof(value)) < 0) {
+        qErrnoWarning(errno, "can not wake up reactor");
+    }
+}
+
+void EventReactor::onWakeup()
+{
+    quint64 value = 0;
+    if (read(m_wakeupFd, &value, sizeof(value)) < 0 && errno != EAGAIN)
+        return;
+
+    QList<Task> tasks;
+    {
+        QMutexLocker locker(&m_postedTasksMutex);
+        tasks.swap(m_postedTasks);
+    }
+
+    for (auto task : tasks) {
+        task();
+    }
+}
+
+void EventReactor::onControlConnection()
+{
+    int fd;
+    while ((fd = accept4(m_controlFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+        m_controlBuffers.insert(fd, QByteArray());
+        addFd(fd, [=](quint32 events) {
+            if (events & EPOLLIN) {
+                onControlData(fd);
+            } else if (events & EPOLLOUT) {
+                flushControlReplies(fd);
+            } else {
+                closeControlClient(fd);
+            }
+        }, EPOLLIN | EPOLLRDHUP);
+    }
+}
+
+void EventReactor::onControlData(int fd)
+{
+    char buffer[512];
+    ssize_t len;
+    while ((len = read(fd, buffer, sizeof(buffer))) > 0) {
+        QByteArray &data = m_controlBuffers[fd];
+        QByteArray &replies = m_controlReplies[fd];
+        data.append(buffer, len);
+
+        int index;
+        while ((index = data.indexOf('\n')) >= 0) {
+            QByteArray command = data.left(index).trimmed();
+            data.remove(0, index + 1);
+            if (command.isEmpty())
+                continue;
+
+            replies.append(m_controlHandler(command));
+            if (!replies.endsWith('\n'))
+                replies.append('\n');
+        }
+
+        // a line longer than any command, or the replies are never read.
+        if (data.size() > MAX_CONTROL_COMMAND_SIZE || replies.size() > MAX_CONTROL_REPLY_SIZE) {
+            qWarning("control client %d overflowed, closed", fd);
+            closeControlClient(fd);
+            return;
+        }
+    }
+
+    // closed by the client, but the pending replies are sent yet.
+    if (len == 0 || errno != EAGAIN)
+        m_closingControlClients.insert(fd);
+
+    flushControlReplies(fd);
+}
+
+void EventReactor::flushControlReplies(int fd)
+{
+    QByteArray &replies = m_controlReplies[fd];
+    while (!replies.isEmpty()) {
+        ssize_t written = send(fd, replies.constData(), replies.size(), MSG_NOSIGNAL);
+        if (written > 0) {
+            replies.remove(0, written);
+            continue;
+        }
+        if (written < 0 && errno == EAGAIN)
+            break;
+
+        closeControlClient(fd);
+        return;
+    }
+
+    bool isClosing = m_closingControlClients.contains(fd);
+    if (isClosing && replies.isEmpty()) {
+        closeControlClient(fd);
+        return;
+    }
+
+    // the writable event is watched only while a reply is pending.
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = (isClosing? 0: EPOLLIN | EPOLLRDHUP) | (replies.isEmpty()? 0: EPOLLOUT);
+    ev.data.fd = fd;
+    epoll_ctl(m_epollFd, EPOLL_CTL_MOD, fd, &ev);
+}
+
+void EventReactor::closeControlClient(int fd)
+{
+    removeFd(fd);
+    m_controlBuffers.remove(fd);
+    m_controlReplies.remove(fd);
+    m_closingControlClients.remove(fd);
+    close(fd);
+}
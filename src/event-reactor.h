@@ -0,0 +1,129 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef EVENTREACTOR_H
+#define EVENTREACTOR_H
+
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include <QByteArray>
+#include <QString>
+#include <QMutex>
+#include <QAtomicInt>
+
+#include <functional>
+
+#include <sys/epoll.h>
+
+/*!
+ * \brief The EventReactor class
+ * is a single threaded epoll loop. It multiplexes the libinput fd, the
+ * gesture deadline timers (timerfd), the process signals (signalfd), the
+ * settings file (inotify) and an optional control socket, and it handles
+ * all the sources which are ready in one wakeup as a batch.
+ *
+ * Except post() and stop(), every method should be called from the thread
+ * which runs the reactor.
+ */
+class EventReactor
+{
+public:
+    typedef std::function<void (quint32 events)> FdHandler;
+    typedef std::function<void ()> Task;
+    typedef std::function<void (int signo)> SignalHandler;
+    typedef std::function<QByteArray (const QByteArray &command)> ControlHandler;
+
+    EventReactor();
+    ~EventReactor();
+
+    /*!
+     * \brief current
+     * \return the reactor running in current thread, or nullptr.
+     */
+    static EventReactor *current();
+
+    /*!
+     * \brief blockSignals
+     * signals handled by signalfd must be blocked in every thread, call
+     * this before any other thread is spawned.
+     */
+    static bool blockSignals(const QList<int> &signalList);
+
+    bool isValid() const {return m_epollFd >= 0;}
+
+    bool addFd(int fd, FdHandler handler, quint32 events = EPOLLIN);
+    void removeFd(int fd);
+
+    /*!
+     * \brief createTimer
+     * \return a timer id (a timerfd), or -1 if failed.
+     * the timer is one-shot, it will be disarmed after \a task was invoked.
+     */
+    int createTimer(Task task);
+    void startTimer(int timer, quint64 usec);
+    void stopTimer(int timer);
+    void destroyTimer(int timer);
+
+    bool watchSignals(const QList<int> &signalList, SignalHandler handler);
+    bool watchFile(const QString &path, Task task);
+    bool listenControlSocket(const QString &path, ControlHandler handler);
+
+    /*!
+     * \brief post
+     * queue \a task into the reactor thread, it is thread safe.
+     */
+    void post(Task task);
+
+    void run();
+    void stop();
+
+private:
+    void onWakeup();
+    void onControlConnection();
+    void onControlData(int fd);
+    void flushControlReplies(int fd);
+    void closeControlClient(int fd);
+
+    int m_epollFd = -1;
+    int m_wakeupFd = -1;
+    int m_signalFd = -1;
+    int m_inotifyFd = -1;
+    int m_controlFd = -1;
+
+    // cleared by stop(), which may come before run() from another thread.
+    QAtomicInt m_running {1};
+
+    QHash<int, FdHandler> m_handlers;
+
+    QMutex m_postedTasksMutex;
+    QList<Task> m_postedTasks;
+
+    QString m_watchedFileName;
+    QString m_controlSocketPath;
+    ControlHandler m_controlHandler;
+    QHash<int, QByteArray> m_controlBuffers;
+    QHash<int, QByteArray> m_controlReplies;
+    QSet<int> m_closingControlClients;
+};
+
+#endif // EVENTREACTOR_H
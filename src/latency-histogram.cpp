@@ -0,0 +1,103 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "latency-histogram.h"
+
+#include <QtMath>
+
+void LatencyHistogram::record(quint64 value)
+{
+    m_counts[bucketIndex(value)]++;
+
+    if (m_count == 0 || value < m_minimum)
+        m_minimum = value;
+    if (value > m_maximum)
+        m_maximum = value;
+
+    m_count++;
+    m_sum += value;
+}
+
+void LatencyHistogram::reset()
+{
+    *this = LatencyHistogram();
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    if (other.m_count == 0)
+        return;
+
+    for (int i = 0; i < LATENCY_HISTOGRAM_BUCKET_COUNT; i++)
+        m_counts[i] += other.m_counts[i];
+
+    if (m_count == 0 || other.m_minimum < m_minimum)
+        m_minimum = other.m_minimum;
+    if (other.m_maximum > m_maximum)
+        m_maximum = other.m_maximum;
+
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+}
+
+quint64 LatencyHistogram::percentile(double percent) const
+{
+    if (m_count == 0)
+        return 0;
+
+    quint64 target = quint64(qCeil(qBound(0.0, percent, 100.0) / 100 * m_count));
+    if (target == 0)
+        target = 1;
+
+    quint64 total = 0;
+    for (int i = 0; i < LATENCY_HISTOGRAM_BUCKET_COUNT; i++) {
+        total += m_counts[i];
+        if (total >= target)
+            return qMin(bucketUpperBound(i), m_maximum);
+    }
+
+    return m_maximum;
+}
+
+int LatencyHistogram::bucketIndex(quint64 value)
+{
+    if (value < LATENCY_HISTOGRAM_LINEAR_COUNT)
+        return int(value);
+
+    // keep the highest LATENCY_HISTOGRAM_SUB_BITS + 1 bits of the value.
+    int shift = 63 - __builtin_clzll(value) - LATENCY_HISTOGRAM_SUB_BITS;
+    if (shift > LATENCY_HISTOGRAM_MAX_SHIFT)
+        return LATENCY_HISTOGRAM_BUCKET_COUNT - 1;
+
+    int top = int(value >> shift);
+    return LATENCY_HISTOGRAM_LINEAR_COUNT + (shift - 1) * LATENCY_HISTOGRAM_SUB_COUNT + (top - LATENCY_HISTOGRAM_SUB_COUNT);
+}
+
+quint64 LatencyHistogram::bucketUpperBound(int index)
+{
+    if (index < LATENCY_HISTOGRAM_LINEAR_COUNT)
+        return quint64(index);
+
+    int shift = (index - LATENCY_HISTOGRAM_LINEAR_COUNT) / LATENCY_HISTOGRAM_SUB_COUNT + 1;
+    quint64 top = (index - LATENCY_HISTOGRAM_LINEAR_COUNT) % LATENCY_HISTOGRAM_SUB_COUNT + LATENCY_HISTOGRAM_SUB_COUNT;
+    return ((top + 1) << shift) - 1;
+}
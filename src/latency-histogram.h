@@ -0,0 +1,76 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QtGlobal>
+
+// values below are recorded exactly, 1 << LATENCY_HISTOGRAM_SUB_BITS sub
+// buckets for each power of two above, so the error is less than 1/32.
+#define LATENCY_HISTOGRAM_SUB_BITS 5
+#define LATENCY_HISTOGRAM_SUB_COUNT (1 << LATENCY_HISTOGRAM_SUB_BITS)
+#define LATENCY_HISTOGRAM_LINEAR_COUNT (2 * LATENCY_HISTOGRAM_SUB_COUNT)
+#define LATENCY_HISTOGRAM_MAX_SHIFT 31 // about 38 hours in usec
+#define LATENCY_HISTOGRAM_BUCKET_COUNT (LATENCY_HISTOGRAM_LINEAR_COUNT + LATENCY_HISTOGRAM_MAX_SHIFT * LATENCY_HISTOGRAM_SUB_COUNT)
+
+/*!
+ * \brief The LatencyHistogram class
+ * a fixed size, log-linear (HDR style) histogram of latencies in usec.
+ * Recording never allocates, and any percentile is reported as the highest
+ * value of its bucket, with a bounded relative error.
+ */
+class LatencyHistogram
+{
+public:
+    void record(quint64 value);
+    void reset();
+
+    /*!
+     * \brief merge
+     * add the values recorded by another histogram into this one.
+     */
+    void merge(const LatencyHistogram &other);
+
+    quint64 count() const {return m_count;}
+    quint64 minimum() const {return m_count? m_minimum: 0;}
+    quint64 maximum() const {return m_maximum;}
+    double mean() const {return m_count? double(m_sum)/m_count: 0;}
+
+    /*!
+     * \brief percentile
+     * \param percent 0 to 100.
+     */
+    quint64 percentile(double percent) const;
+
+private:
+    static int bucketIndex(quint64 value);
+    static quint64 bucketUpperBound(int index);
+
+    quint64 m_counts[LATENCY_HISTOGRAM_BUCKET_COUNT] = {};
+    quint64 m_count = 0;
+    quint64 m_sum = 0;
+    quint64 m_minimum = 0;
+    quint64 m_maximum = 0;
+};
+
+#endif // LATENCYHISTOGRAM_H
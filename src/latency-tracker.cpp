@@ -0,0 +1,126 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "latency-tracker.h"
+
+#include <QStringList>
+#include <QThread>
+#include <QMap>
+#include <QDebug>
+
+#include <time.h>
+
+static LatencyTracker *instance = nullptr;
+
+LatencyTracker *LatencyTracker::getTracker()
+{
+    if (!instance)
+        instance = new LatencyTracker;
+    return instance;
+}
+
+quint64 LatencyTracker::now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return quint64(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+int LatencyTracker::registerHistogram(const QString &name)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto thread = QThread::currentThread();
+    int count = m_entryCount.loadAcquire();
+    for (int i = 0; i < count; i++) {
+        if (m_entries[i]->thread == thread && m_entries[i]->name == name)
+            return i;
+    }
+
+    if (count == LATENCY_TRACKER_MAX_HISTOGRAMS) {
+        qWarning()<<"too many latency histograms,"<<name<<"is not recorded";
+        return -1;
+    }
+
+    auto entry = new Entry;
+    entry->name = name;
+    entry->thread = thread;
+    m_entries[count] = entry;
+    // publish the entry to the recording threads.
+    m_entryCount.storeRelease(count + 1);
+    return count;
+}
+
+void LatencyTracker::record(int index, quint64 eventTime)
+{
+    if (index < 0 || index >= m_entryCount.loadAcquire())
+        return;
+
+    quint64 current = now();
+    // replayed recordings carry the timestamps of the past.
+    if (eventTime == 0 || eventTime > current)
+        return;
+
+    Entry *entry = m_entries[index];
+    QMutexLocker locker(&entry->mutex);
+    entry->histogram.record(current - eventTime);
+}
+
+QString LatencyTracker::dump()
+{
+    QMutexLocker locker(&m_mutex);
+
+    QMap<QString, LatencyHistogram> histograms;
+    int count = m_entryCount.loadAcquire();
+    for (int i = 0; i < count; i++) {
+        Entry *entry = m_entries[i];
+        QMutexLocker entryLocker(&entry->mutex);
+        if (entry->histogram.count() > 0)
+            histograms[entry->name].merge(entry->histogram);
+    }
+
+    QStringList lines;
+    for (auto it = histograms.constBegin(); it != histograms.constEnd(); ++it) {
+        const LatencyHistogram &histogram = it.value();
+        lines<<QString("%1: count %2 min %3 mean %4 p50 %5 p90 %6 p99 %7 p99.9 %8 max %9 usec")
+               .arg(it.key()).arg(histogram.count()).arg(histogram.minimum())
+               .arg(histogram.mean(), 0, 'f', 1)
+               .arg(histogram.percentile(50)).arg(histogram.percentile(90))
+               .arg(histogram.percentile(99)).arg(histogram.percentile(99.9))
+               .arg(histogram.maximum());
+    }
+
+    if (lines.isEmpty())
+        return "no gesture recorded";
+    return lines.join("\n");
+}
+
+void LatencyTracker::reset()
+{
+    QMutexLocker locker(&m_mutex);
+
+    int count = m_entryCount.loadAcquire();
+    for (int i = 0; i < count; i++) {
+        QMutexLocker entryLocker(&m_entries[i]->mutex);
+        m_entries[i]->histogram.reset();
+    }
+}
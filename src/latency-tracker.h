@@ -0,0 +1,98 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef LATENCYTRACKER_H
+#define LATENCYTRACKER_H
+
+#include <QString>
+#include <QMutex>
+#include <QAtomicInt>
+
+#include "latency-histogram.h"
+
+class QThread;
+
+#define LATENCY_TRACKER_MAX_HISTOGRAMS 512
+
+/*!
+ * \brief The LatencyTracker class
+ * keeps a latency histogram for each kind of gesture, from the kernel
+ * timestamp of the event which triggered the gesture to the moment the
+ * translated events were written to uinput. It is shared by the input
+ * threads of all seats.
+ *
+ * The histograms are registered by name before the gestures happen, each
+ * thread gets its own ones, and they are merged by name in dump(). So the
+ * recording is a lookup by index and a lock which is only contended by
+ * dump() and reset().
+ */
+class LatencyTracker
+{
+public:
+    static LatencyTracker *getTracker();
+
+    /*!
+     * \brief now
+     * \return CLOCK_MONOTONIC in usec, the clock of the event timestamps.
+     */
+    static quint64 now();
+
+    /*!
+     * \brief registerHistogram
+     * \return the index of the histogram of the name for the calling
+     * thread, it is created at the first time. -1 if there are too many.
+     */
+    int registerHistogram(const QString &name);
+
+    /*!
+     * \brief record
+     * \param index given by registerHistogram(), nothing is recorded if it
+     * is -1. It never allocates.
+     * \param eventTime the timestamp of the triggering event, in usec.
+     */
+    void record(int index, quint64 eventTime);
+
+    /*!
+     * \brief dump
+     * \return a line for each kind of gesture, with its count, mean and
+     * percentiles in usec.
+     */
+    QString dump();
+    void reset();
+
+private:
+    LatencyTracker() {}
+
+    struct Entry {
+        QString name;
+        QThread *thread = nullptr;
+        QMutex mutex;
+        LatencyHistogram histogram;
+    };
+
+    // guards the registration, the entries are never removed.
+    QMutex m_mutex;
+    Entry *m_entries[LATENCY_TRACKER_MAX_HISTOGRAMS] = {};
+    QAtomicInt m_entryCount;
+};
+
+#endif // LATENCYTRACKER_H
@@ -0,0 +1,94 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "logind-watcher.h"
+
+#include <QDBusConnection>
+#include <QDBusInterface>
+#include <QDebug>
+
+#include <ctype.h>
+
+#define LOGIND_SERVICE "org.freedesktop.login1"
+
+LogindWatcher::LogindWatcher(const QString &seat, QObject *parent) : QObject(parent)
+{
+    // logind escapes the other characters than [A-Za-z0-9] as _xx.
+    m_seatPath = "/org/freedesktop/login1/seat/";
+    for (auto c : seat.toLatin1()) {
+        if (isalnum(c))
+            m_seatPath.append(c);
+        else
+            m_seatPath.append(QString("_%1").arg(uchar(c), 2, 16, QChar('0')));
+    }
+
+    QDBusConnection bus = QDBusConnection::systemBus();
+    if (!bus.isConnected()) {
+        qWarning()<<"can not connect to system bus, idle mode is disabled";
+        return;
+    }
+
+    bus.connect(LOGIND_SERVICE, "/org/freedesktop/login1", "org.freedesktop.login1.Manager",
+                "PrepareForSleep", this, SLOT(onPrepareForSleep(bool)));
+    bus.connect(LOGIND_SERVICE, m_seatPath, "org.freedesktop.DBus.Properties",
+                "PropertiesChanged", this, SLOT(onSeatPropertiesChanged(QString,QVariantMap,QStringList)));
+
+    m_isSeatIdle = queryIdleHint();
+    m_isIdle = m_isSeatIdle;
+}
+
+void LogindWatcher::onPrepareForSleep(bool start)
+{
+    m_isSleeping = start;
+    update();
+}
+
+void LogindWatcher::onSeatPropertiesChanged(const QString &interface, const QVariantMap &changed, const QStringList &invalidated)
+{
+    if (interface != "org.freedesktop.login1.Seat")
+        return;
+
+    if (changed.contains("IdleHint")) {
+        m_isSeatIdle = changed.value("IdleHint").toBool();
+    } else if (invalidated.contains("IdleHint")) {
+        m_isSeatIdle = queryIdleHint();
+    } else {
+        return;
+    }
+    update();
+}
+
+bool LogindWatcher::queryIdleHint()
+{
+    QDBusInterface seat(LOGIND_SERVICE, m_seatPath, "org.freedesktop.login1.Seat", QDBusConnection::systemBus());
+    return seat.property("IdleHint").toBool();
+}
+
+void LogindWatcher::update()
+{
+    bool isIdle = m_isSleeping || m_isSeatIdle;
+    if (isIdle == m_isIdle)
+        return;
+
+    m_isIdle = isIdle;
+    emit idleChanged(isIdle);
+}
@@ -0,0 +1,63 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef LOGINDWATCHER_H
+#define LOGINDWATCHER_H
+
+#include <QObject>
+#include <QVariantMap>
+#include <QStringList>
+
+/*!
+ * \brief The LogindWatcher class
+ * tells whether a seat is idle, that is the IdleHint of the seat is set
+ * (the screen is blanked or locked by the session) or the system is going
+ * to sleep. It lives in the main thread, which runs a Qt event loop for
+ * the system bus.
+ */
+class LogindWatcher : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LogindWatcher(const QString &seat, QObject *parent = nullptr);
+
+    bool isIdle() const {return m_isIdle;}
+
+signals:
+    void idleChanged(bool isIdle);
+
+private slots:
+    void onPrepareForSleep(bool start);
+    void onSeatPropertiesChanged(const QString &interface, const QVariantMap &changed, const QStringList &invalidated);
+
+private:
+    bool queryIdleHint();
+    void update();
+
+    QString m_seatPath;
+
+    bool m_isSleeping = false;
+    bool m_isSeatIdle = false;
+    bool m_isIdle = false;
+};
+
+#endif // LOGINDWATCHER_H
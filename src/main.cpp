@@ -24,60 +24,179 @@
 
 #include "event-monitor.h"
 
-#include "touch-screen/touch-screen-gesture-manager.h"
-#include "touch-screen/touch-screen-three-finger-swipe-gesture.h"
-#include "touch-screen/touch-screen-four-finger-swipe-gesture.h"
-#include "touch-screen/touch-screen-five-finger-swipe-gesture.h"
-#include "touch-screen/touch-screen-three-finger-zoom-gesture.h"
-#include "touch-screen/touch-screen-four-finger-zoom-gesture.h"
-#include "touch-screen/touch-screen-five-finger-zoom-gesture.h"
-#include "touch-screen/touch-screen-two-finger-tap-gesture.h"
-#include "touch-screen/touch-screen-two-finger-swipe-gesture.h"
-#include "touch-screen/touch-screen-two-finger-zoom-gesture.h"
-#include "touch-screen/touch-screen-two-finger-drag-and-tap-gesture.h"
-
-#include "touch-screen/touch-screen-one-finger-edge-gesture.h"
-
-#include "touchpad/touchpad-gesture-manager.h"
-
 #include "settings-manager.h"
-#include "uinput-helper.h"
+#include "event-reactor.h"
+#include "touch-device-manager.h"
+#include "logind-watcher.h"
 
 #include <QThread>
+#include <QCommandLineParser>
+#include <QDebug>
+
+#include <signal.h>
 
 int main(int argc, char *argv[])
 {
     QCoreApplication a(argc, argv);
 
-    QThread t1;
-
-    // init manager
-    auto manager = TouchScreenGestureManager::getManager();
-    TouchpadGestureManager::getManager();
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Translate touch event to keyborad shortcut");
+    parser.addHelpOption();
+
+    QCommandLineOption socketNotifierOption("socket-notifier",
+                                            "Watch libinput from the main event loop instead of the reactor thread, "
+                                            "so gestures are recognized and executed on one thread.");
+    parser.addOption(socketNotifierOption);
+
+    QCommandLineOption controlSocketOption("control-socket",
+                                           "Listen for control commands on a unix socket, "
+                                           "only available without --socket-notifier.",
+                                           "path");
+    parser.addOption(controlSocketOption);
+
+    QCommandLineOption backendOption("backend",
+                                     "Read touch screens by \"libinput\" (default) or \"evdev\" directly.",
+                                     "backend", "libinput");
+    parser.addOption(backendOption);
+
+    QCommandLineOption evdevDeviceOption("evdev-device",
+                                         "Touch screen device node, or a recorded input_event file to replay, "
+                                         "for the evdev backend. All touch screens are opened if it is not set.",
+                                         "path");
+    parser.addOption(evdevDeviceOption);
+
+    QCommandLineOption evdevRecordOption("evdev-record",
+                                         "Record the events of the evdev touch screens with their axes into the directory, "
+                                         "which can be replayed by --evdev-device.",
+                                         "directory");
+    parser.addOption(evdevRecordOption);
+
+    QCommandLineOption seatOption("seat",
+                                  "Only translate the touch devices of the seat, default is seat0.",
+                                  "seat", "seat0");
+    parser.addOption(seatOption);
+
+    QCommandLineOption allSeatsOption("all-seats",
+                                      "Translate the touch devices of every seat, each seat has its own "
+                                      "recognizers, virtual device and reactor thread.");
+    parser.addOption(allSeatsOption);
+
+    // the real-time profile, they override the group "realtime" of gestures.conf.
+    QCommandLineOption rtPolicyOption("rt-policy",
+                                      "Scheduling policy of the input threads, \"normal\", \"fifo\" or \"rr\".",
+                                      "policy");
+    parser.addOption(rtPolicyOption);
+
+    QCommandLineOption rtPriorityOption("rt-priority",
+                                        "Real-time priority of the input threads for fifo and rr policy.",
+                                        "priority");
+    parser.addOption(rtPriorityOption);
+
+    QCommandLineOption rtCpusOption("rt-cpus",
+                                    "Bind the input threads to the cpus, like \"1,3-4\".",
+                                    "cpus");
+    parser.addOption(rtCpusOption);
+
+    QCommandLineOption rtLockMemoryOption("rt-lock-memory",
+                                          "Lock the memory of the process, so the input path never page faults.");
+    parser.addOption(rtLockMemoryOption);
+
+    QCommandLineOption suspendWhenIdleOption("suspend-when-idle",
+                                             "Close the touch devices of a seat while it is idle by logind, "
+                                             "or the system is going to sleep.");
+    parser.addOption(suspendWhenIdleOption);
+    parser.process(a);
+
+    bool useReactor = !parser.isSet(socketNotifierOption);
+    if (useReactor) {
+        // handled by the signalfd of event reactor, block them
+        // before any other thread is spawned.
+        EventReactor::blockSignals(QList<int>()<<SIGTERM<<SIGHUP<<SIGUSR1);
+    }
+
+    // init manager, the gesture managers and the virtual device are
+    // created for each seat by event monitor.
     SettingsManager::getManager();
 
-    UInputHelper::getInstance();
-
-    // init gesutre and register into gesture manager
-    TouchScreenThreeFingerSwipeGesture *threeFingerSwipe = new TouchScreenThreeFingerSwipeGesture(manager);
-    TouchScreenFourFingerSwipeGesture *fourFingerSwipe = new TouchScreenFourFingerSwipeGesture(manager);
-    TouchScreenFiveFingerSwipeGesture *fiveFingerSwipe = new TouchScreenFiveFingerSwipeGesture(manager);
-    TouchScreenThreeFingerZoomGesture *threeFingerZoom = new TouchScreenThreeFingerZoomGesture(manager);
-    TouchScreenFourFingerZoomGesture *fourFingerZoom = new TouchScreenFourFingerZoomGesture(manager);
-    TouchScreenFiveFingerZoomGesture *fiveFingerZoom = new TouchScreenFiveFingerZoomGesture(manager);
-    TouchScreenTwoFingerTapGesture *twoFingerTap = new TouchScreenTwoFingerTapGesture(manager);
-    TouchScreenTwoFingerSwipeGesture *twoFingerSwipe = new TouchScreenTwoFingerSwipeGesture(manager);
-    TouchScreenTwoFingerZoomGesture *twoFingerZoom = new TouchScreenTwoFingerZoomGesture(manager);
-    TouchScreenTwoFingerDragAndTapGesture *twoFingerDragAndTap = new TouchScreenTwoFingerDragAndTapGesture(manager);
-
-    TouchScreenOneFingerEdgeGesture *oneFingerEdge = new TouchScreenOneFingerEdgeGesture(manager);
-
-    EventMonitor em;
-    em.initTouchScreenGestureManager(manager);
-    em.moveToThread(&t1);
-
-    t1.connect(&t1, &QThread::started, &em, &EventMonitor::startMonitor);
-    t1.start();
-
-    return a.exec();
+    RealtimeProfile realtimeProfile = SettingsManager::getManager()->realtimeProfile();
+    if (parser.isSet(rtPolicyOption) && !RealtimeProfile::parsePolicy(parser.value(rtPolicyOption), realtimeProfile.policy))
+        qWarning()<<"invalid realtime policy"<<parser.value(rtPolicyOption);
+    if (parser.isSet(rtPriorityOption))
+        realtimeProfile.priority = parser.value(rtPriorityOption).toInt();
+    if (parser.isSet(rtCpusOption) && !RealtimeProfile::parseCpus(parser.value(rtCpusOption), realtimeProfile.cpus))
+        qWarning()<<"invalid realtime cpus"<<parser.value(rtCpusOption);
+    if (parser.isSet(rtLockMemoryOption))
+        realtimeProfile.lockMemory = true;
+
+    // before the threads are spawned, so their stacks are locked too.
+    realtimeProfile.lockProcessMemory();
+
+    QStringList seats;
+    if (parser.isSet(allSeatsOption)) {
+        seats = TouchDeviceManager::findSeats();
+    } else {
+        seats<<parser.value(seatOption);
+    }
+
+    QList<EventMonitor *> monitors;
+    for (auto seat : seats) {
+        auto em = new EventMonitor;
+        em->setSeat(seat);
+        // the first one handles signals, settings file and control socket,
+        // the given evdev devices belong to it too.
+        em->setPrimary(monitors.isEmpty());
+        em->setRealtimeProfile(realtimeProfile);
+        if (parser.value(backendOption) == "evdev") {
+            em->setBackend(EventMonitor::EvdevBackend,
+                           monitors.isEmpty()? parser.values(evdevDeviceOption): QStringList());
+            em->setEvdevRecordDirectory(parser.value(evdevRecordOption));
+        }
+        monitors<<em;
+
+        if (parser.isSet(suspendWhenIdleOption)) {
+            // lives in main thread, the monitor is suspended thread safely.
+            auto watcher = new LogindWatcher(seat, &a);
+            QObject::connect(watcher, &LogindWatcher::idleChanged, watcher, [=](bool isIdle) {
+                em->setSuspended(isIdle);
+            });
+            if (watcher->isIdle())
+                em->setSuspended(true);
+        }
+    }
+
+    if (!useReactor) {
+        // gesture managers live in main thread, signals of gestures
+        // will be delivered directly without a queued connection.
+        SettingsManager::getManager()->watchSettingsFile();
+        for (auto em : monitors)
+            em->startNotifier();
+        return a.exec();
+    }
+
+    // recognize and execute gestures in the reactor thread of each seat,
+    // so a busy seat never delays the others.
+    monitors.first()->setControlSocketPath(parser.value(controlSocketOption));
+
+    QList<QThread *> threads;
+    for (auto em : monitors) {
+        auto thread = new QThread;
+        em->moveToThread(thread);
+        thread->connect(thread, &QThread::started, em, &EventMonitor::startMonitor);
+        thread->start();
+        threads<<thread;
+    }
+
+    int ret = a.exec();
+
+    for (auto em : monitors)
+        em->stopMonitor();
+    for (auto thread : threads) {
+        thread->quit();
+        thread->wait();
+    }
+
+    qDeleteAll(monitors);
+    qDeleteAll(threads);
+
+    return ret;
 }
@@ -0,0 +1,157 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "realtime-profile.h"
+
+#include <QStringList>
+#include <QDebug>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <errno.h>
+#include <string.h>
+
+// the stack which is touched once, so the hot path never faults on it.
+#define PREFAULT_STACK_SIZE (64 * 1024)
+
+bool RealtimeProfile::parsePolicy(const QString &string, RealtimeProfile::Policy &policy)
+{
+    if (string == "normal" || string == "other") {
+        policy = Normal;
+    } else if (string == "fifo") {
+        policy = Fifo;
+    } else if (string == "rr") {
+        policy = RoundRobin;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool RealtimeProfile::parseCpus(const QString &string, QList<int> &cpus)
+{
+    QList<int> list;
+    for (auto range : string.split(",", QString::SkipEmptyParts)) {
+        QStringList bounds = range.trimmed().split("-");
+        bool ok1 = false;
+        bool ok2 = false;
+        int first = bounds.first().toInt(&ok1);
+        int last = bounds.last().toInt(&ok2);
+        if (bounds.count() > 2 || !ok1 || !ok2 || first < 0 || last < first || last >= CPU_SETSIZE)
+            return false;
+        for (int cpu = first; cpu <= last; cpu++)
+            list<<cpu;
+    }
+
+    cpus = list;
+    return true;
+}
+
+bool RealtimeProfile::lockProcessMemory()
+{
+    if (!lockMemory)
+        return true;
+
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        qErrnoWarning(errno, "realtime: can not lock memory, try LimitMEMLOCK=infinity");
+        m_memory = Denied;
+        return false;
+    }
+
+    qInfo()<<"realtime: memory locked";
+    m_memory = Granted;
+    return true;
+}
+
+bool RealtimeProfile::applyToCurrentThread()
+{
+    bool granted = true;
+
+    if (policy != Normal) {
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        int schedPolicy = policy == Fifo? SCHED_FIFO: SCHED_RR;
+        param.sched_priority = qBound(sched_get_priority_min(schedPolicy), priority, sched_get_priority_max(schedPolicy));
+
+        // pthread functions return the error number instead of setting errno.
+        int error = pthread_setschedparam(pthread_self(), schedPolicy, &param);
+        if (error != 0) {
+            qErrnoWarning(error, "realtime: can not set scheduling policy, try LimitRTPRIO or CAP_SYS_NICE");
+            m_scheduling = Denied;
+            granted = false;
+        } else {
+            m_scheduling = Granted;
+        }
+    }
+
+    if (!cpus.isEmpty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (auto cpu : cpus)
+            CPU_SET(cpu, &set);
+
+        int error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (error != 0) {
+            qErrnoWarning(error, "realtime: can not set cpu affinity");
+            m_affinity = Denied;
+            granted = false;
+        } else {
+            m_affinity = Granted;
+        }
+    }
+
+    if (m_memory == Granted) {
+        // the locked stack is only mapped when it is touched.
+        volatile char stack[PREFAULT_STACK_SIZE];
+        for (int i = 0; i < PREFAULT_STACK_SIZE; i += 4096)
+            stack[i] = 0;
+    }
+
+    qInfo().noquote()<<"realtime:"<<status();
+    return granted;
+}
+
+QString RealtimeProfile::status() const
+{
+    QStringList cpuList;
+    for (auto cpu : cpus)
+        cpuList<<QString::number(cpu);
+
+    static const char *policyNames[] = {"normal", "fifo", "rr"};
+    return QString("policy %1 priority %2 %3, cpus %4 %5, memory lock %6")
+            .arg(policyNames[policy]).arg(priority).arg(resultString(m_scheduling))
+            .arg(cpuList.isEmpty()? "all": cpuList.join(",")).arg(resultString(m_affinity))
+            .arg(resultString(m_memory));
+}
+
+const char *RealtimeProfile::resultString(RealtimeProfile::Result result)
+{
+    switch (result) {
+    case Granted:
+        return "granted";
+    case Denied:
+        return "denied";
+    default:
+        return "not requested";
+    }
+}
@@ -0,0 +1,100 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef REALTIMEPROFILE_H
+#define REALTIMEPROFILE_H
+
+#include <QString>
+#include <QList>
+
+/*!
+ * \brief The RealtimeProfile class
+ * describes the opt-in real-time setup of the input threads: a SCHED_FIFO
+ * or SCHED_RR priority, the CPU affinity and the locked memory. It only
+ * asks for the privileges, whether they are granted is logged and can be
+ * queried by status(), the translator keeps working without them.
+ */
+class RealtimeProfile
+{
+public:
+    enum Policy {
+        Normal,
+        Fifo,
+        RoundRobin
+    };
+
+    Policy policy = Normal;
+    int priority = 0;
+    QList<int> cpus; // empty for all cpus
+    bool lockMemory = false;
+
+    bool isEnabled() const {return policy != Normal || !cpus.isEmpty() || lockMemory;}
+
+    /*!
+     * \brief parsePolicy
+     * \param string "normal", "fifo" or "rr".
+     */
+    static bool parsePolicy(const QString &string, Policy &policy);
+
+    /*!
+     * \brief parseCpus
+     * \param string a cpu list like "1,3-4".
+     */
+    static bool parseCpus(const QString &string, QList<int> &cpus);
+
+    /*!
+     * \brief lockProcessMemory
+     * lock the current and future pages of the process by mlockall(), so
+     * there will be no page fault in the input path. Call it once from the
+     * main thread before the input threads are spawned.
+     */
+    bool lockProcessMemory();
+
+    /*!
+     * \brief applyToCurrentThread
+     * set the scheduling policy and the affinity of the calling thread, and
+     * prefault its stack.
+     * \return false if any of them is not granted.
+     */
+    bool applyToCurrentThread();
+
+    /*!
+     * \brief status
+     * \return a line describing what is requested and what is granted.
+     */
+    QString status() const;
+
+private:
+    enum Result {
+        NotRequested,
+        Granted,
+        Denied
+    };
+
+    static const char *resultString(Result result);
+
+    Result m_scheduling = NotRequested;
+    Result m_affinity = NotRequested;
+    Result m_memory = NotRequested;
+};
+
+#endif // REALTIMEPROFILE_H
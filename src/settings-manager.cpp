@@ -23,6 +23,7 @@
 #include "settings-manager.h"
 
 #include <QSettings>
+#include <QMutexLocker>
 
 #include <QFileSystemWatcher>
 
@@ -47,14 +48,6 @@ SettingsManager::SettingsManager(QObject *parent) : QObject(parent)
     m_settings = new QSettings(QSettings::SystemScope, "ukui", "gestures", this);
     qDebug()<<m_settings->fileName();
 
-    QFileSystemWatcher *watcher = new QFileSystemWatcher(QStringList()<<m_settings->fileName(), this);
-    connect(watcher, &QFileSystemWatcher::fileChanged, this, [=](){
-        qDebug()<<"file changed, sync";
-        m_settings->sync();
-        // we should rewatch the changed file.
-        watcher->addPath(m_settings->fileName());
-    });
-
     if (!m_settings->childGroups().isEmpty()) {
         return;
     }
@@ -79,6 +72,9 @@ SettingsManager::SettingsManager(QObject *parent) : QObject(parent)
     setToucScreenShortCut(TouchScreenGestureInterface::Zoom, TouchScreenGestureInterface::Finished, TouchScreenGestureInterface::ZoomIn, 5, QKeySequence("Meta+PgUp"));
     setToucScreenShortCut(TouchScreenGestureInterface::Zoom, TouchScreenGestureInterface::Finished, TouchScreenGestureInterface::ZoomOut, 5, QKeySequence("Meta+PgDn"));
 
+    setToucScreenShortCut(TouchScreenGestureInterface::Rotate, TouchScreenGestureInterface::Finished, TouchScreenGestureInterface::RotateClockwise, 2, QKeySequence("Ctrl+R"));
+    setToucScreenShortCut(TouchScreenGestureInterface::Rotate, TouchScreenGestureInterface::Finished, TouchScreenGestureInterface::RotateCounterClockwise, 2, QKeySequence("Ctrl+Shift+R"));
+
     setToucScreenShortCut(TouchScreenGestureInterface::Edge, TouchScreenGestureInterface::Finished, TouchScreenGestureInterface::Up, 1, QKeySequence("Meta+D"));
     setToucScreenShortCut(TouchScreenGestureInterface::Edge, TouchScreenGestureInterface::Finished, TouchScreenGestureInterface::Down, 1, QKeySequence("Ctrl+Alt+W"));
 
@@ -99,6 +95,9 @@ SettingsManager::SettingsManager(QObject *parent) : QObject(parent)
     setTouchPadShortCut(TouchpadGestureManager::Pinch, TouchpadGestureManager::Finished, TouchpadGestureManager::ZoomIn, 2, QKeySequence("Ctrl++"));
     setTouchPadShortCut(TouchpadGestureManager::Pinch, TouchpadGestureManager::Finished, TouchpadGestureManager::ZoomOut, 2, QKeySequence("Ctrl+-"));
 
+    setTouchPadShortCut(TouchpadGestureManager::Rotate, TouchpadGestureManager::Finished, TouchpadGestureManager::RotateClockwise, 2, QKeySequence("Ctrl+R"));
+    setTouchPadShortCut(TouchpadGestureManager::Rotate, TouchpadGestureManager::Finished, TouchpadGestureManager::RotateCounterClockwise, 2, QKeySequence("Ctrl+Shift+R"));
+
     m_settings->sync();
 }
 
@@ -109,12 +108,139 @@ SettingsManager *SettingsManager::getManager()
     return instance;
 }
 
+QString SettingsManager::fileName()
+{
+    return m_settings->fileName();
+}
+
+RealtimeProfile SettingsManager::realtimeProfile()
+{
+    QMutexLocker locker(&m_mutex);
+
+    RealtimeProfile profile;
+    m_settings->beginGroup("realtime");
+    if (!RealtimeProfile::parsePolicy(m_settings->value("policy", "normal").toString(), profile.policy))
+        qWarning()<<"invalid realtime policy"<<m_settings->value("policy");
+    profile.priority = m_settings->value("priority", 0).toInt();
+    if (!RealtimeProfile::parseCpus(m_settings->value("cpus").toString(), profile.cpus))
+        qWarning()<<"invalid realtime cpus"<<m_settings->value("cpus");
+    profile.lockMemory = m_settings->value("lockMemory", false).toBool();
+    m_settings->endGroup();
+
+    return profile;
+}
+
+quint32 SettingsManager::getConflicts(TouchScreenGestureInterface::GestureType type, quint32 defaultConflicts)
+{
+    QMutexLocker locker(&m_mutex);
+    QString key = QString("conflicts/%1").arg(m_touchScreenGestureType.valueToKey(type));
+    if (!m_settings->contains(key))
+        return defaultConflicts;
+
+    quint32 conflicts = 0;
+    for (auto name : m_settings->value(key).toStringList()) {
+        bool ok = false;
+        int value = m_touchScreenGestureType.keyToValue(name.trimmed().toLatin1().constData(), &ok);
+        if (ok && value >= 0 && value < 32)
+            conflicts |= 1u << value;
+        else if (!name.trimmed().isEmpty())
+            qWarning()<<"unknown gesture type"<<name<<"in"<<key;
+    }
+    return conflicts;
+}
+
+bool SettingsManager::isEarlyCommitEnabled()
+{
+    QMutexLocker locker(&m_mutex);
+    return m_settings->value("touch screen/earlyCommit", false).toBool();
+}
+
+int SettingsManager::getMaxTapCount(int fingerCount)
+{
+    if (!getShortCut(TouchScreenGestureInterface::TripleTap, fingerCount, TouchScreenGestureInterface::Finished, TouchScreenGestureInterface::None).isEmpty())
+        return 3;
+    if (!getShortCut(TouchScreenGestureInterface::DoubleTap, fingerCount, TouchScreenGestureInterface::Finished, TouchScreenGestureInterface::None).isEmpty())
+        return 2;
+    return 1;
+}
+
+int SettingsManager::tapInterval()
+{
+    QMutexLocker locker(&m_mutex);
+    return qBound(50, m_settings->value("tap/interval", 250).toInt(), 1000);
+}
+
+KineticScroller::Profile SettingsManager::kineticScrollProfile()
+{
+    QMutexLocker locker(&m_mutex);
+
+    KineticScroller::Profile profile;
+    m_settings->beginGroup("kinetic");
+    profile.enabled = m_settings->value("enabled", profile.enabled).toBool();
+    profile.friction = qMax(0.0, m_settings->value("friction", profile.friction).toDouble());
+    profile.deceleration = qMax(0.0, m_settings->value("deceleration", profile.deceleration).toDouble());
+    profile.minVelocity = qMax(1.0, m_settings->value("minVelocity", profile.minVelocity).toDouble());
+    profile.interval = qBound(1000, m_settings->value("interval", profile.interval).toInt(), 100000);
+    m_settings->endGroup();
+
+    return profile;
+}
+
+TouchPointFilter::Profile SettingsManager::touchFilterProfile(const QString &deviceName)
+{
+    QMutexLocker locker(&m_mutex);
+
+    TouchPointFilter::Profile profile;
+    auto readProfile = [&]() {
+        profile.enabled = m_settings->value("enabled", profile.enabled).toBool();
+        profile.minCutoff = qMax(0.01, m_settings->value("minCutoff", profile.minCutoff).toDouble());
+        profile.beta = qMax(0.0, m_settings->value("beta", profile.beta).toDouble());
+        profile.derivativeCutoff = qMax(0.01, m_settings->value("derivativeCutoff", profile.derivativeCutoff).toDouble());
+    };
+
+    m_settings->beginGroup("filter");
+    readProfile();
+    if (!deviceName.isEmpty() && m_settings->childGroups().contains(deviceName)) {
+        m_settings->beginGroup(deviceName);
+        readProfile();
+        m_settings->endGroup();
+    }
+    m_settings->endGroup();
+
+    qDebug()<<deviceName<<"touch filter enabled:"<<profile.enabled<<profile.minCutoff<<profile.beta<<profile.derivativeCutoff;
+    return profile;
+}
+
+void SettingsManager::reload()
+{
+    qDebug()<<"file changed, sync";
+    QMutexLocker locker(&m_mutex);
+    m_settings->sync();
+    m_generation.fetchAndAddOrdered(1);
+}
+
+void SettingsManager::watchSettingsFile()
+{
+    QFileSystemWatcher *watcher = new QFileSystemWatcher(QStringList()<<m_settings->fileName(), this);
+    connect(watcher, &QFileSystemWatcher::fileChanged, this, [=](){
+        reload();
+        // we should rewatch the changed file.
+        watcher->addPath(m_settings->fileName());
+    });
+}
+
 QKeySequence SettingsManager::getShortCut(TouchScreenGestureInterface *gesture, TouchScreenGestureInterface::State state, TouchScreenGestureInterface::Direction direction)
 {
+    return getShortCut(gesture->type(), gesture->finger(), state, direction);
+}
+
+QKeySequence SettingsManager::getShortCut(TouchScreenGestureInterface::GestureType type, int fingerCount, TouchScreenGestureInterface::State state, TouchScreenGestureInterface::Direction direction)
+{
+    QMutexLocker locker(&m_mutex);
     m_settings->beginGroup("touch screen");
-    m_settings->beginGroup(m_touchScreenGestureType.valueToKey(gesture->type()));
+    m_settings->beginGroup(m_touchScreenGestureType.valueToKey(type));
     m_settings->beginReadArray(m_touchScreenGestureState.valueToKey(state));
-    m_settings->setArrayIndex(gesture->finger());
+    m_settings->setArrayIndex(fingerCount);
     auto shortcut = qvariant_cast<QKeySequence>(m_settings->value(m_touchScreenGestureDirection.valueToKey(direction)));
     m_settings->endArray();
     m_settings->endGroup();
@@ -122,8 +248,23 @@ QKeySequence SettingsManager::getShortCut(TouchScreenGestureInterface *gesture,
     return shortcut;
 }
 
+double SettingsManager::getUpdateStep(TouchScreenGestureInterface::GestureType type, int fingerCount)
+{
+    QMutexLocker locker(&m_mutex);
+    m_settings->beginGroup("touch screen");
+    m_settings->beginGroup(m_touchScreenGestureType.valueToKey(type));
+    m_settings->beginReadArray(m_touchScreenGestureState.valueToKey(TouchScreenGestureInterface::Update));
+    m_settings->setArrayIndex(fingerCount);
+    double step = m_settings->value("step", 0).toDouble();
+    m_settings->endArray();
+    m_settings->endGroup();
+    m_settings->endGroup();
+    return qMax(0.0, step);
+}
+
 QKeySequence SettingsManager::gesShortCut(int fingerCount, TouchpadGestureManager::GestureType type, TouchpadGestureManager::State state, TouchpadGestureManager::Direction direction)
 {
+    QMutexLocker locker(&m_mutex);
     m_settings->beginGroup("touchpad");
     m_settings->beginGroup(m_touchpadGestureType.valueToKey(type));
 
@@ -140,6 +281,7 @@ QKeySequence SettingsManager::gesShortCut(int fingerCount, TouchpadGestureManage
 
 void SettingsManager::setToucScreenShortCut(TouchScreenGestureInterface::GestureType type, TouchScreenGestureInterface::State state, TouchScreenGestureInterface::Direction direction, int fingerCount, QKeySequence shortCut)
 {
+    QMutexLocker locker(&m_mutex);
     m_settings->beginGroup("touch screen");
     m_settings->beginGroup(m_touchScreenGestureType.valueToKey(type));
     m_settings->beginWriteArray(m_touchScreenGestureState.valueToKey(state));
@@ -153,6 +295,7 @@ void SettingsManager::setToucScreenShortCut(TouchScreenGestureInterface::Gesture
 
 void SettingsManager::setTouchPadShortCut(TouchpadGestureManager::GestureType type, TouchpadGestureManager::State state, TouchpadGestureManager::Direction direction, int fingerCount, QKeySequence shortCut)
 {
+    QMutexLocker locker(&m_mutex);
     m_settings->beginGroup("touchpad");
     m_settings->beginGroup(m_touchpadGestureType.valueToKey(type));
     m_settings->beginWriteArray(m_touchpadGestureState.valueToKey(state));
@@ -27,8 +27,13 @@
 #include <QKeySequence>
 
 #include <QMetaEnum>
+#include <QMutex>
+#include <QAtomicInt>
 #include "touch-screen/touch-screen-gesture-interface.h"
 #include "touchpad/touchpad-gesture-manager.h"
+#include "realtime-profile.h"
+#include "touch-screen/kinetic-scroller.h"
+#include "touch-screen/touch-point-filter.h"
 
 class TouchScreenGestureInterface;
 class QSettings;
@@ -43,14 +48,99 @@ public:
                              TouchScreenGestureInterface::State state,
                              TouchScreenGestureInterface::Direction direction);
 
+    QKeySequence getShortCut(TouchScreenGestureInterface::GestureType type,
+                             int fingerCount,
+                             TouchScreenGestureInterface::State state,
+                             TouchScreenGestureInterface::Direction direction);
+
+    /*!
+     * \brief getUpdateStep
+     * \return the value of key "step" besides the Update bindings of the
+     * gesture, the distance in mm, or degrees for rotation, which the bound
+     * shortcut is executed once for. 0 if it is not set.
+     */
+    double getUpdateStep(TouchScreenGestureInterface::GestureType type, int fingerCount);
+
+    /*!
+     * \brief getConflicts
+     * \return the gesture types which lose when a gesture of the type
+     * updates, as bits of (1 << type). The value of key <type> in group
+     * "conflicts", a list of types like "Swipe, Rotate", or the default.
+     */
+    quint32 getConflicts(TouchScreenGestureInterface::GestureType type, quint32 defaultConflicts);
+
+    /*!
+     * \brief generation
+     * \return a number changed every time the settings are reloaded, for
+     * the values cached by the gesture managers.
+     */
+    int generation() const {return m_generation.loadAcquire();}
+
+    /*!
+     * \brief isEarlyCommitEnabled
+     * \return the value of key "earlyCommit" in group "touch screen", if a
+     * gesture is executed as soon as it is sure, rather than when all
+     * fingers are released.
+     */
+    bool isEarlyCommitEnabled();
+
+    /*!
+     * \brief getMaxTapCount
+     * \return 3 if the TripleTap of the fingers is bound, 2 if the
+     * DoubleTap is, otherwise 1. A tap sequence is committed as soon as
+     * it reaches this count.
+     */
+    int getMaxTapCount(int fingerCount);
+
+    /*!
+     * \brief tapInterval
+     * \return the value of key "interval" in group "tap", the longest time
+     * from a tap released to the next one pressed, in msec.
+     */
+    int tapInterval();
+
     QKeySequence gesShortCut(int fingerCount,
                              TouchpadGestureManager::GestureType type,
                              TouchpadGestureManager::State state,
                              TouchpadGestureManager::Direction direction);
 
+    QString fileName();
+
+    /*!
+     * \brief realtimeProfile
+     * \return the profile of group "realtime", with the keys policy (normal,
+     * fifo or rr), priority, cpus (like "1,3-4") and lockMemory.
+     */
+    RealtimeProfile realtimeProfile();
+
+    /*!
+     * \brief kineticScrollProfile
+     * \return the profile of group "kinetic", with the keys enabled,
+     * friction, deceleration, minVelocity and interval, see
+     * KineticScroller::Profile.
+     */
+    KineticScroller::Profile kineticScrollProfile();
+
+    /*!
+     * \brief touchFilterProfile
+     * \return the profile of group "filter", with the keys enabled,
+     * minCutoff, beta and derivativeCutoff, see TouchPointFilter::Profile.
+     * They are overridden by the ones in the subgroup of the device name.
+     */
+    TouchPointFilter::Profile touchFilterProfile(const QString &deviceName);
+
 signals:
 
 public slots:
+    void reload();
+
+    /*!
+     * \brief watchSettingsFile
+     * reload the settings by a QFileSystemWatcher. It is not needed if the
+     * settings file is watched by the event reactor.
+     */
+    void watchSettingsFile();
+
     void setToucScreenShortCut(TouchScreenGestureInterface::GestureType type,
                                TouchScreenGestureInterface::State state,
                                TouchScreenGestureInterface::Direction direction,
@@ -67,6 +157,11 @@ private:
     explicit SettingsManager(QObject *parent = nullptr);
     QSettings *m_settings;
 
+    // the gestures of every seat are executed in its own thread, and the
+    // groups of m_settings are not shared safely.
+    QMutex m_mutex;
+    QAtomicInt m_generation;
+
     QMetaEnum m_touchScreenGestureType;
     QMetaEnum m_touchScreenGestureState;
     QMetaEnum m_touchScreenGestureDirection;
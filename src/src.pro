@@ -1,4 +1,4 @@
-QT += gui
+QT += gui dbus
 
 TARGET = libinput-touch-translator
 
@@ -7,6 +7,11 @@ CONFIG -= app_bundle
 
 PKGCONFIG += libinput libudev
 
+# the hold gestures of touchpads are added in libinput 1.19.
+system(pkg-config --atleast-version=1.19 libinput) {
+    DEFINES += HAVE_LIBINPUT_HOLD_GESTURES
+}
+
 # The following define makes your compiler emit warnings if you use
 # any Qt feature that has been marked deprecated (the exact warnings
 # depend on your compiler). Please consult the documentation of the
@@ -22,9 +27,17 @@ include(touch-screen/touch-screen.pri)
 include(touchpad/touchpad.pri)
 
 SOURCES += \
+        deadline-timer.cpp \
+        evdev-touch-source.cpp \
         event-monitor.cpp \
+        event-reactor.cpp \
+        latency-histogram.cpp \
+        latency-tracker.cpp \
+        logind-watcher.cpp \
         main.cpp \
+        realtime-profile.cpp \
         settings-manager.cpp \
+        touch-device-manager.cpp \
         uinput-helper.cpp
 
 target.path = /usr/libexec
@@ -35,6 +48,14 @@ service.path = /lib/systemd/system
 INSTALLS += service
 
 HEADERS += \
+    deadline-timer.h \
+    evdev-touch-source.h \
     event-monitor.h \
+    event-reactor.h \
+    latency-histogram.h \
+    latency-tracker.h \
+    logind-watcher.h \
+    realtime-profile.h \
     settings-manager.h \
+    touch-device-manager.h \
     uinput-helper.h
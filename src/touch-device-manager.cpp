@@ -0,0 +1,206 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "touch-device-manager.h"
+
+#include <libudev.h>
+#include <string.h>
+
+#include <QDebug>
+
+TouchDeviceManager::TouchDeviceManager(QObject *parent) : QObject(parent)
+{
+    m_udev = udev_new();
+}
+
+TouchDeviceManager::~TouchDeviceManager()
+{
+    if (m_monitor)
+        udev_monitor_unref(m_monitor);
+    if (m_udev)
+        udev_unref(m_udev);
+}
+
+QStringList TouchDeviceManager::findSeats()
+{
+    QStringList seats;
+    seats<<"seat0";
+
+    struct udev *udev = udev_new();
+    if (!udev)
+        return seats;
+
+    struct udev_enumerate *enumerate = udev_enumerate_new(udev);
+    udev_enumerate_add_match_subsystem(enumerate, "input");
+    udev_enumerate_add_match_sysname(enumerate, "event*");
+    udev_enumerate_scan_devices(enumerate);
+
+    struct udev_list_entry *entry;
+    udev_list_entry_foreach(entry, udev_enumerate_get_list_entry(enumerate)) {
+        struct udev_device *device = udev_device_new_from_syspath(udev, udev_list_entry_get_name(entry));
+        if (!device)
+            continue;
+
+        DeviceType type;
+        if (matchType(device, type)) {
+            const char *seat = udev_device_get_property_value(device, "ID_SEAT");
+            if (seat && !seats.contains(seat))
+                seats<<seat;
+        }
+        udev_device_unref(device);
+    }
+
+    udev_enumerate_unref(enumerate);
+    udev_unref(udev);
+
+    return seats;
+}
+
+void TouchDeviceManager::setSeat(const QString &seat)
+{
+    m_seat = seat;
+}
+
+bool TouchDeviceManager::start()
+{
+    if (!m_udev || m_monitor)
+        return m_monitor != nullptr;
+
+    // monitor first, so a device plugged during the enumeration isn't lost.
+    m_monitor = udev_monitor_new_from_netlink(m_udev, "udev");
+    if (!m_monitor) {
+        qWarning()<<"can not create udev monitor";
+        return false;
+    }
+    udev_monitor_filter_add_match_subsystem_devtype(m_monitor, "input", NULL);
+    udev_monitor_enable_receiving(m_monitor);
+
+    struct udev_enumerate *enumerate = udev_enumerate_new(m_udev);
+    udev_enumerate_add_match_subsystem(enumerate, "input");
+    udev_enumerate_add_match_sysname(enumerate, "event*");
+    udev_enumerate_scan_devices(enumerate);
+
+    struct udev_list_entry *entry;
+    udev_list_entry_foreach(entry, udev_enumerate_get_list_entry(enumerate)) {
+        struct udev_device *device = udev_device_new_from_syspath(m_udev, udev_list_entry_get_name(entry));
+        if (!device)
+            continue;
+        addDevice(device);
+        udev_device_unref(device);
+    }
+    udev_enumerate_unref(enumerate);
+
+    if (m_devices.isEmpty())
+        qWarning()<<"no touch device found on"<<m_seat<<", maybe permission problem.";
+
+    return true;
+}
+
+int TouchDeviceManager::fd() const
+{
+    return m_monitor ? udev_monitor_get_fd(m_monitor) : -1;
+}
+
+void TouchDeviceManager::dispatch()
+{
+    if (!m_monitor)
+        return;
+
+    struct udev_device *device;
+    while ((device = udev_monitor_receive_device(m_monitor)) != NULL) {
+        const char *action = udev_device_get_action(device);
+        if (action && strcmp(action, "add") == 0)
+            addDevice(device);
+        else if (action && strcmp(action, "remove") == 0)
+            removeDevice(device);
+        udev_device_unref(device);
+    }
+}
+
+bool TouchDeviceManager::matchType(udev_device *device, DeviceType &type)
+{
+    // the properties are also set on the parent input device, which has no node.
+    if (!udev_device_get_devnode(device))
+        return false;
+    if (!QString(udev_device_get_sysname(device)).startsWith("event"))
+        return false;
+
+    const char *ignore = udev_device_get_property_value(device, "LIBINPUT_IGNORE_DEVICE");
+    if (ignore && strcmp(ignore, "1") == 0)
+        return false;
+
+    const char *value = udev_device_get_property_value(device, "ID_INPUT_TOUCHSCREEN");
+    if (value && strcmp(value, "1") == 0) {
+        type = TouchScreen;
+        return true;
+    }
+
+    value = udev_device_get_property_value(device, "ID_INPUT_TOUCHPAD");
+    if (value && strcmp(value, "1") == 0) {
+        type = Touchpad;
+        return true;
+    }
+
+    return false;
+}
+
+bool TouchDeviceManager::matchDevice(udev_device *device, DeviceType &type) const
+{
+    const char *seat = udev_device_get_property_value(device, "ID_SEAT");
+    if (m_seat != (seat ? seat : "seat0"))
+        return false;
+
+    return matchType(device, type);
+}
+
+void TouchDeviceManager::addDevice(udev_device *device)
+{
+    DeviceType type;
+    if (!matchDevice(device, type))
+        return;
+
+    QString devnode = udev_device_get_devnode(device);
+    if (m_devices.contains(devnode))
+        return;
+
+    m_devices.insert(devnode, type);
+    qDebug()<<type<<devnode<<"added";
+    emit deviceAdded(devnode, type);
+}
+
+void TouchDeviceManager::removeDevice(udev_device *device)
+{
+    // the properties of a removed device may be incomplete, look it up by node.
+    const char *node = udev_device_get_devnode(device);
+    if (!node)
+        return;
+
+    QString devnode = node;
+    auto it = m_devices.find(devnode);
+    if (it == m_devices.end())
+        return;
+
+    DeviceType type = it.value();
+    m_devices.erase(it);
+    qDebug()<<type<<devnode<<"removed";
+    emit deviceRemoved(devnode, type);
+}
@@ -0,0 +1,103 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef TOUCHDEVICEMANAGER_H
+#define TOUCHDEVICEMANAGER_H
+
+#include <QObject>
+#include <QHash>
+#include <QStringList>
+
+struct udev;
+struct udev_device;
+struct udev_monitor;
+
+/*!
+ * \brief The TouchDeviceManager class
+ * finds the touch screens and touchpads of a seat by their udev properties,
+ * and follows the hotplug of them with a udev monitor. Keyboards, mice and
+ * the other input devices are never reported, so they won't be opened by
+ * libinput and won't wake us up.
+ */
+class TouchDeviceManager : public QObject
+{
+    Q_OBJECT
+public:
+    enum DeviceType {
+        TouchScreen,
+        Touchpad
+    };
+    Q_ENUM(DeviceType)
+
+    explicit TouchDeviceManager(QObject *parent = nullptr);
+    ~TouchDeviceManager();
+
+    /*!
+     * \brief findSeats
+     * \return the seats which have any touch screen or touchpad, seat0
+     * is always the first one.
+     */
+    static QStringList findSeats();
+
+    void setSeat(const QString &seat);
+    QString seat() const {return m_seat;}
+
+    /*!
+     * \brief start
+     * start monitoring and report the present devices with deviceAdded().
+     * \return false if udev is not available.
+     */
+    bool start();
+
+    /*!
+     * \brief fd
+     * \return the udev monitor fd, call dispatch() when it is readable.
+     */
+    int fd() const;
+
+    /*!
+     * \brief dispatch
+     * read the pending uevents, and report the added or removed devices.
+     */
+    void dispatch();
+
+    QStringList devices() const {return m_devices.keys();}
+    DeviceType deviceType(const QString &devnode) const {return m_devices.value(devnode);}
+
+signals:
+    void deviceAdded(const QString &devnode, TouchDeviceManager::DeviceType type);
+    void deviceRemoved(const QString &devnode, TouchDeviceManager::DeviceType type);
+
+private:
+    static bool matchType(udev_device *device, DeviceType &type);
+    bool matchDevice(udev_device *device, DeviceType &type) const;
+    void addDevice(udev_device *device);
+    void removeDevice(udev_device *device);
+
+    udev *m_udev = nullptr;
+    udev_monitor *m_monitor = nullptr;
+
+    QString m_seat = "seat0";
+    QHash<QString, DeviceType> m_devices;
+};
+
+#endif // TOUCHDEVICEMANAGER_H
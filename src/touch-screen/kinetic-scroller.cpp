@@ -0,0 +1,80 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "kinetic-scroller.h"
+
+#include "uinput-helper.h"
+#include "latency-tracker.h"
+
+#include <QtMath>
+
+// the distance of a wheel notch, same as scrolling with two fingers.
+#define KINETIC_SCROLL_STEP 10 // mm
+
+KineticScroller::KineticScroller(UInputHelper *output) :
+    m_timer([=](){onTick();})
+{
+    m_output = output;
+}
+
+void KineticScroller::fling(double vx, double vy)
+{
+    stop();
+
+    if (!m_profile.enabled || qSqrt(vx * vx + vy * vy) < m_profile.minVelocity)
+        return;
+
+    m_vx = vx;
+    m_vy = vy;
+    m_lastTick = LatencyTracker::now();
+    m_timer.start(m_profile.interval);
+}
+
+void KineticScroller::stop()
+{
+    m_timer.stop();
+    m_vx = 0;
+    m_vy = 0;
+}
+
+void KineticScroller::onTick()
+{
+    quint64 now = LatencyTracker::now();
+    double dt = double(now - m_lastTick) / 1000000;
+    m_lastTick = now;
+
+    // integrate the distance of this tick by the velocity at its start, the
+    // fractions of a notch are accumulated by the uinput helper.
+    m_output->wheel(QPointF(m_vx * dt / KINETIC_SCROLL_STEP, m_vy * dt / KINETIC_SCROLL_STEP));
+
+    // decay the speed, keeping the direction.
+    double speed = qSqrt(m_vx * m_vx + m_vy * m_vy);
+    double decayed = speed * qExp(-m_profile.friction * dt) - m_profile.deceleration * dt;
+    if (decayed < m_profile.minVelocity) {
+        stop();
+        return;
+    }
+
+    m_vx *= decayed / speed;
+    m_vy *= decayed / speed;
+    m_timer.start(m_profile.interval);
+}
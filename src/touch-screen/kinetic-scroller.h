@@ -0,0 +1,79 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef KINETICSCROLLER_H
+#define KINETICSCROLLER_H
+
+#include "deadline-timer.h"
+
+class UInputHelper;
+
+/*!
+ * \brief The KineticScroller class
+ * keeps scrolling after the fingers are released, by the release velocity.
+ * The velocity decays by the friction on every tick, and the distance is
+ * written as wheel events until it drops below the minimum velocity, or
+ * the scroller is stopped by the next touch down. It runs in the thread
+ * of the touch screen and doesn't allocate after the first fling.
+ */
+class KineticScroller
+{
+public:
+    struct Profile {
+        bool enabled = true;
+        // dv/dt = -friction * v - deceleration, the first part is the
+        // exponential decay and the second one is the constant braking.
+        double friction = 4; // 1/s
+        double deceleration = 200; // mm/s^2
+        double minVelocity = 30; // mm/s, the velocity which a fling starts or stops at
+        int interval = 16667; // usec, the ticks, about the refresh rate of display
+    };
+
+    explicit KineticScroller(UInputHelper *output);
+
+    void setProfile(const Profile &profile) {m_profile = profile;}
+
+    /*!
+     * \brief fling
+     * \param vx in mm/s
+     * \param vy in mm/s
+     */
+    void fling(double vx, double vy);
+
+    void stop();
+
+    bool isActive() const {return m_timer.isActive();}
+
+private:
+    void onTick();
+
+    UInputHelper *m_output = nullptr;
+    Profile m_profile;
+
+    DeadlineTimer m_timer;
+    quint64 m_lastTick = 0;
+
+    double m_vx = 0;
+    double m_vy = 0;
+};
+
+#endif // KINETICSCROLLER_H
@@ -0,0 +1,255 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "touch-frame.h"
+
+#include <QtAlgorithms>
+
+TouchSlotMap::TouchSlotMap()
+{
+    reset();
+}
+
+int TouchSlotMap::acquire(int slot)
+{
+    int index = find(slot);
+    if (index >= 0)
+        return index;
+
+    quint32 freeMask = ~m_usedMask & ((1u << TOUCH_FRAME_MAX_SLOTS) - 1);
+    if (!freeMask)
+        return -1;
+
+    index = qCountTrailingZeroBits(freeMask);
+    m_slots[index] = slot;
+    m_usedMask |= 1u << index;
+    return index;
+}
+
+int TouchSlotMap::find(int slot) const
+{
+    quint32 usedMask = m_usedMask;
+    while (usedMask) {
+        int index = qCountTrailingZeroBits(usedMask);
+        usedMask &= usedMask - 1;
+        if (m_slots[index] == slot)
+            return index;
+    }
+    return -1;
+}
+
+void TouchSlotMap::detach(int index)
+{
+    if (index < 0 || index >= TOUCH_FRAME_MAX_SLOTS)
+        return;
+
+    m_slots[index] = -1;
+}
+
+void TouchSlotMap::release(int index)
+{
+    if (index < 0 || index >= TOUCH_FRAME_MAX_SLOTS)
+        return;
+
+    m_usedMask &= ~(1u << index);
+    m_slots[index] = -1;
+}
+
+void TouchSlotMap::reset()
+{
+    for (int i = 0; i < TOUCH_FRAME_MAX_SLOTS; i++)
+        m_slots[i] = -1;
+    m_usedMask = 0;
+}
+
+TouchFrameDecoder::TouchFrameDecoder()
+{
+    reset();
+}
+
+bool TouchFrameDecoder::decode(libinput_event *event)
+{
+    auto type = libinput_event_get_type(event);
+    switch (type) {
+    case LIBINPUT_EVENT_TOUCH_DOWN:
+    case LIBINPUT_EVENT_TOUCH_MOTION: {
+        auto touch_event = libinput_event_get_touch_event(event);
+        // single touch devices have no slot.
+        int slot = qMax(0, libinput_event_touch_get_slot(touch_event));
+        quint64 time = libinput_event_touch_get_time_usec(touch_event);
+
+        double x = libinput_event_touch_get_x(touch_event);
+        double y = libinput_event_touch_get_y(touch_event);
+        double nx = libinput_event_touch_get_x_transformed(touch_event, 1);
+        double ny = libinput_event_touch_get_y_transformed(touch_event, 1);
+
+        if (type == LIBINPUT_EVENT_TOUCH_DOWN)
+            return touchDown(slot, time, x, y, nx, ny);
+        return touchMotion(slot, time, x, y, nx, ny);
+    }
+    case LIBINPUT_EVENT_TOUCH_UP: {
+        auto touch_event = libinput_event_get_touch_event(event);
+        int slot = qMax(0, libinput_event_touch_get_slot(touch_event));
+        return touchUp(slot, libinput_event_touch_get_time_usec(touch_event));
+    }
+    case LIBINPUT_EVENT_TOUCH_FRAME: {
+        auto touch_event = libinput_event_get_touch_event(event);
+        return touchFrame(libinput_event_touch_get_time_usec(touch_event));
+    }
+    case LIBINPUT_EVENT_TOUCH_CANCEL: {
+        auto touch_event = libinput_event_get_touch_event(event);
+        int slot = qMax(0, libinput_event_touch_get_slot(touch_event));
+        return touchCancel(slot, libinput_event_touch_get_time_usec(touch_event));
+    }
+    default:
+        break;
+    }
+
+    return false;
+}
+
+void TouchFrameDecoder::reset()
+{
+    m_frame = TouchFrame();
+    m_slotMap.reset();
+    for (int i = 0; i < TOUCH_FRAME_MAX_SLOTS; i++)
+        m_velocityTrackers[i].reset();
+}
+
+bool TouchFrameDecoder::touchDown(int slot, quint64 time, double x, double y, double nx, double ny, double major, double pressure)
+{
+    // too many contacts, the extra ones are ignored.
+    int index = m_slotMap.acquire(slot);
+    if (index < 0)
+        return false;
+
+    beginEvent(TouchFrame::Down, index, time);
+    setPosition(index, x, y, nx, ny, major, pressure);
+    m_filters[index].reset(time, x, y, nx, ny);
+    m_frame.downTime[index] = time;
+    m_frame.deviceSlot[index] = slot;
+    m_frame.vx[index] = 0;
+    m_frame.vy[index] = 0;
+    // the samples are added by frame events.
+    m_velocityTrackers[index].reset();
+
+    if (!m_frame.isActive(index)) {
+        m_frame.activeMask |= 1u << index;
+        m_frame.fingerCount++;
+    }
+    m_frame.downMask |= 1u << index;
+    return true;
+}
+
+bool TouchFrameDecoder::touchMotion(int slot, quint64 time, double x, double y, double nx, double ny, double major, double pressure)
+{
+    int index = m_slotMap.find(slot);
+    if (index < 0 || !m_frame.isActive(index))
+        return false;
+
+    beginEvent(TouchFrame::Motion, index, time);
+    if (m_filterProfile.enabled)
+        m_filters[index].filter(m_filterProfile, time, x, y, nx, ny);
+    setPosition(index, x, y, nx, ny, major, pressure);
+    return true;
+}
+
+bool TouchFrameDecoder::touchUp(int slot, quint64 time)
+{
+    int index = m_slotMap.find(slot);
+    if (index < 0 || !m_frame.isActive(index))
+        return false;
+
+    // keep the last position of the slot, recognizers might need it.
+    beginEvent(TouchFrame::Up, index, time);
+    m_velocityTrackers[index].estimate(time, m_frame.vx[index], m_frame.vy[index]);
+    release(index);
+    return true;
+}
+
+bool TouchFrameDecoder::touchFrame(quint64 time)
+{
+    beginEvent(TouchFrame::Frame, -1, time);
+
+    quint32 activeMask = m_frame.activeMask;
+    while (activeMask) {
+        int index = qCountTrailingZeroBits(activeMask);
+        activeMask &= activeMask - 1;
+        TouchVelocityTracker &tracker = m_velocityTrackers[index];
+        tracker.addSample(time, m_frame.x[index], m_frame.y[index]);
+        tracker.estimate(time, m_frame.vx[index], m_frame.vy[index]);
+    }
+    return true;
+}
+
+bool TouchFrameDecoder::touchCancel(int slot, quint64 time)
+{
+    int index = m_slotMap.find(slot);
+    if (index < 0)
+        return false;
+
+    beginEvent(TouchFrame::Cancel, index, time);
+    if (m_frame.isActive(index))
+        release(index);
+    return true;
+}
+
+void TouchFrameDecoder::beginEvent(TouchFrame::EventType type, int slot, quint64 time)
+{
+    // a frame event closes the frame, the flags are for the next one.
+    if (m_frame.type == TouchFrame::Frame) {
+        // the released indexes are given to the next contacts from now on,
+        // so they are not reused in the frame which reports them up.
+        quint32 upMask = m_frame.upMask & ~m_frame.activeMask;
+        while (upMask) {
+            int index = qCountTrailingZeroBits(upMask);
+            upMask &= upMask - 1;
+            m_slotMap.release(index);
+        }
+        m_frame.downMask = 0;
+        m_frame.upMask = 0;
+    }
+
+    m_frame.type = type;
+    m_frame.slot = slot;
+    m_frame.time = time;
+}
+
+void TouchFrameDecoder::setPosition(int slot, double x, double y, double nx, double ny, double major, double pressure)
+{
+    m_frame.x[slot] = x;
+    m_frame.y[slot] = y;
+    m_frame.nx[slot] = nx;
+    m_frame.ny[slot] = ny;
+    m_frame.major[slot] = major;
+    m_frame.pressure[slot] = pressure;
+}
+
+void TouchFrameDecoder::release(int index)
+{
+    // a new contact of the slot in this frame, e.g. a replaced tracking id,
+    // gets a fresh index, and this one keeps its last position.
+    m_slotMap.detach(index);
+    m_frame.activeMask &= ~(1u << index);
+    m_frame.upMask |= 1u << index;
+    m_frame.fingerCount--;
+}
@@ -0,0 +1,182 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef TOUCHFRAME_H
+#define TOUCHFRAME_H
+
+#include <QtGlobal>
+#include <QPointF>
+
+#include <libinput.h>
+
+#include "touch-point-filter.h"
+#include "touch-velocity-tracker.h"
+
+#define TOUCH_FRAME_MAX_SLOTS 16
+
+/*!
+ * \brief The TouchFrame struct
+ * is a snapshot of all touch points of a touch screen, it is updated by
+ * every touch event and shared by all the recognizers.
+ *
+ * The slot table is stored as arrays, so the positions of all fingers are
+ * packed in a few cache lines. It is indexed by the dense index of the
+ * contacts which is given by TouchSlotMap, not the slot of the device.
+ */
+struct TouchFrame
+{
+    enum EventType {
+        None,
+        Down,
+        Motion,
+        Up,
+        Frame,
+        Cancel
+    };
+
+    // the event which updated this snapshot.
+    EventType type = None;
+    int slot = -1; // the dense index of the contact
+    quint64 time = 0; // usec, CLOCK_MONOTONIC
+
+    int fingerCount = 0;
+    quint32 activeMask = 0; // slots have finger on the screen
+    quint32 downMask = 0; // slots went down since last frame event
+    quint32 upMask = 0; // slots went up since last frame event
+
+    // in mm
+    float x[TOUCH_FRAME_MAX_SLOTS] = {};
+    float y[TOUCH_FRAME_MAX_SLOTS] = {};
+    // normalized in [0, 1] of the screen
+    float nx[TOUCH_FRAME_MAX_SLOTS] = {};
+    float ny[TOUCH_FRAME_MAX_SLOTS] = {};
+    // usec, when the finger went down
+    quint64 downTime[TOUCH_FRAME_MAX_SLOTS] = {};
+    // contact shape, only reported by the evdev backend, otherwise 0.
+    float major[TOUCH_FRAME_MAX_SLOTS] = {}; // in mm
+    float pressure[TOUCH_FRAME_MAX_SLOTS] = {}; // normalized in [0, 1]
+    // the slot of the device, which the contact is reported by.
+    int deviceSlot[TOUCH_FRAME_MAX_SLOTS] = {};
+    // in mm/s, updated by frame events, and by up events for the released
+    // slot, so it is the release velocity after the finger left.
+    float vx[TOUCH_FRAME_MAX_SLOTS] = {};
+    float vy[TOUCH_FRAME_MAX_SLOTS] = {};
+
+    QPointF position(int slot) const {return QPointF(x[slot], y[slot]);}
+    QPointF normalizedPosition(int slot) const {return QPointF(nx[slot], ny[slot]);}
+    bool isActive(int slot) const {return activeMask & (1u << slot);}
+};
+
+/*!
+ * \brief The TouchSlotMap class
+ * maps the slots of a device to dense indexes of the slot table. A contact
+ * keeps its index until it is released, and the lowest free index is given
+ * to the next contact, so the indexes stay small whatever the device slots
+ * are. It has a fixed capacity and never allocates.
+ */
+class TouchSlotMap
+{
+public:
+    TouchSlotMap();
+
+    /*!
+     * \brief acquire
+     * \return the index of the slot, a new one if the slot is not mapped,
+     * or -1 if all indexes are in use.
+     */
+    int acquire(int slot);
+
+    /*!
+     * \brief find
+     * \return the index of the slot, or -1 if the slot is not mapped.
+     */
+    int find(int slot) const;
+
+    /*!
+     * \brief detach
+     * unmap the slot of the index, but keep the index in use until it is
+     * released, so the next contact of the slot gets another index.
+     */
+    void detach(int index);
+
+    void release(int index);
+
+    void reset();
+
+private:
+    int m_slots[TOUCH_FRAME_MAX_SLOTS];
+    quint32 m_usedMask = 0;
+};
+
+/*!
+ * \brief The TouchFrameDecoder class
+ * decodes every libinput touch event once, and keeps the TouchFrame of
+ * a touch screen up to date.
+ *
+ * The touchDown()/touchMotion()/touchUp()/touchFrame()/touchCancel() are
+ * for the input backends which don't use libinput. The slot of them is the
+ * slot of the device, and up to TOUCH_FRAME_MAX_SLOTS contacts are tracked
+ * at the same time.
+ */
+class TouchFrameDecoder
+{
+public:
+    TouchFrameDecoder();
+
+    /*!
+     * \brief decode
+     * \return false if the event is not a touch event or out of slot table.
+     */
+    bool decode(libinput_event *event);
+
+    const TouchFrame &frame() const {return m_frame;}
+
+    void reset();
+
+    /*!
+     * \brief setFilterProfile
+     * the positions of motion events are smoothed by it before they are
+     * stored in the frame, if it is enabled. It is kept by reset().
+     */
+    void setFilterProfile(const TouchPointFilter::Profile &profile) {m_filterProfile = profile;}
+
+    bool touchDown(int slot, quint64 time, double x, double y, double nx, double ny,
+                   double major = 0, double pressure = 0);
+    bool touchMotion(int slot, quint64 time, double x, double y, double nx, double ny,
+                     double major = 0, double pressure = 0);
+    bool touchUp(int slot, quint64 time);
+    bool touchFrame(quint64 time);
+    bool touchCancel(int slot, quint64 time);
+
+private:
+    void beginEvent(TouchFrame::EventType type, int slot, quint64 time);
+    void setPosition(int slot, double x, double y, double nx, double ny, double major, double pressure);
+    void release(int index);
+
+    TouchFrame m_frame;
+    TouchSlotMap m_slotMap;
+    TouchVelocityTracker m_velocityTrackers[TOUCH_FRAME_MAX_SLOTS];
+    TouchPointFilter m_filters[TOUCH_FRAME_MAX_SLOTS];
+    TouchPointFilter::Profile m_filterProfile;
+};
+
+#endif // TOUCHFRAME_H
@@ -0,0 +1,76 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "touch-point-filter.h"
+
+#include <math.h>
+
+// the smoothing factor of a low pass filter of the cutoff frequency, for
+// the samples te seconds apart.
+static inline float smoothingFactor(float cutoff, float te)
+{
+    float r = 2 * float(M_PI) * cutoff * te;
+    return r / (r + 1);
+}
+
+void TouchPointFilter::reset(quint64 time, double x, double y, double nx, double ny)
+{
+    m_time = time;
+    m_x = x;
+    m_y = y;
+    m_nx = nx;
+    m_ny = ny;
+    m_dx = 0;
+    m_dy = 0;
+}
+
+void TouchPointFilter::filter(const Profile &profile, quint64 time, double &x, double &y, double &nx, double &ny)
+{
+    // several motion events of a contact in the same frame, keep the first.
+    if (time <= m_time) {
+        x = m_x;
+        y = m_y;
+        nx = m_nx;
+        ny = m_ny;
+        return;
+    }
+
+    float te = float(time - m_time) / 1000000;
+    m_time = time;
+
+    float ad = smoothingFactor(profile.derivativeCutoff, te);
+    m_dx += ad * ((float(x) - m_x) / te - m_dx);
+    m_dy += ad * ((float(y) - m_y) / te - m_dy);
+
+    float speed = sqrtf(m_dx * m_dx + m_dy * m_dy);
+    float a = smoothingFactor(profile.minCutoff + profile.beta * speed, te);
+
+    m_x += a * (float(x) - m_x);
+    m_y += a * (float(y) - m_y);
+    m_nx += a * (float(nx) - m_nx);
+    m_ny += a * (float(ny) - m_ny);
+
+    x = m_x;
+    y = m_y;
+    nx = m_nx;
+    ny = m_ny;
+}
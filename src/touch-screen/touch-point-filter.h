@@ -0,0 +1,68 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef TOUCHPOINTFILTER_H
+#define TOUCHPOINTFILTER_H
+
+#include <QtGlobal>
+
+/*!
+ * \brief The TouchPointFilter class
+ * smooths the positions of a contact by a One-Euro filter, a low pass
+ * filter whose cutoff frequency rises with the speed. A resting finger is
+ * smoothed hard against the sensor noise, and a moving one is followed
+ * with little lag. It keeps only the last output of a contact.
+ */
+class TouchPointFilter
+{
+public:
+    struct Profile {
+        bool enabled = false;
+        float minCutoff = 1.5; // Hz, the cutoff of a resting finger
+        float beta = 0.1; // Hz per mm/s, how fast the cutoff rises with the speed
+        float derivativeCutoff = 1; // Hz, the cutoff of the speed itself
+    };
+
+    /*!
+     * \brief reset
+     * start from the position of a new contact, it is not filtered.
+     */
+    void reset(quint64 time, double x, double y, double nx, double ny);
+
+    /*!
+     * \brief filter
+     * replace the position in mm and the normalized position by the
+     * filtered ones, both of them are smoothed by the same factor.
+     */
+    void filter(const Profile &profile, quint64 time, double &x, double &y, double &nx, double &ny);
+
+private:
+    quint64 m_time = 0;
+    float m_x = 0;
+    float m_y = 0;
+    float m_nx = 0;
+    float m_ny = 0;
+    float m_dx = 0; // the filtered velocity, in mm/s
+    float m_dy = 0;
+};
+
+#endif // TOUCHPOINTFILTER_H
@@ -0,0 +1,345 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef TOUCHPOINTKERNELS_H
+#define TOUCHPOINTKERNELS_H
+
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define TOUCH_POINT_KERNELS_SSE2
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define TOUCH_POINT_KERNELS_NEON
+#endif
+
+/*!
+ * \brief The TouchPointKernels class
+ * computes the shape of a set of contacts, which is stored as arrays of x
+ * and y like the slot table of TouchFrame. The loops are vectorized with
+ * SSE2 on x86_64 and NEON on aarch64, and fall back to scalar code on other
+ * architectures.
+ *
+ * The kernels are inline, the overloads of fixed size arrays take the count
+ * as a template parameter, so the loops of the recognizer templates have a
+ * compile time trip count, which the compiler unrolls.
+ *
+ * \note the arrays don't need to be aligned or padded.
+ */
+class TouchPointKernels
+{
+public:
+    static void centroid(const float *x, const float *y, int count, float &cx, float &cy);
+
+    template<int N>
+    static void centroid(const float (&x)[N], const float (&y)[N], float &cx, float &cy) {
+        centroid(x, y, N, cx, cy);
+    }
+
+    /*!
+     * \brief meanRadius
+     * \return the mean distance from the points to the center.
+     */
+    static float meanRadius(const float *x, const float *y, int count, float cx, float cy);
+
+    template<int N>
+    static float meanRadius(const float (&x)[N], const float (&y)[N], float cx, float cy) {
+        return meanRadius(x, y, N, cx, cy);
+    }
+
+    /*!
+     * \brief covariance
+     * computes the covariance matrix of the points around the center.
+     */
+    static void covariance(const float *x, const float *y, int count, float cx, float cy,
+                           float &xx, float &yy, float &xy);
+
+    template<int N>
+    static void covariance(const float (&x)[N], const float (&y)[N], float cx, float cy,
+                           float &xx, float &yy, float &xy) {
+        covariance(x, y, N, cx, cy, xx, yy, xy);
+    }
+
+    /*!
+     * \brief spread
+     * \return twice of the root mean square distance from the points to their
+     * centroid, which is the distance of the points for 2 points.
+     */
+    static float spread(const float *x, const float *y, int count);
+
+    template<int N>
+    static float spread(const float (&x)[N], const float (&y)[N]) {
+        return spread(x, y, N);
+    }
+
+    /*!
+     * \brief rotation
+     * \return the angle in radians, which the points are rotated by around
+     * their centroid from (x0, y0) to (x1, y1), in (-pi, pi]. It is
+     * clockwise on the screen as y is downward.
+     */
+    static float rotation(const float *x0, const float *y0, const float *x1, const float *y1, int count);
+
+    template<int N>
+    static float rotation(const float (&x0)[N], const float (&y0)[N], const float (&x1)[N], const float (&y1)[N]) {
+        return rotation(x0, y0, x1, y1, N);
+    }
+
+private:
+#ifdef TOUCH_POINT_KERNELS_SSE2
+    static float horizontalSum(__m128 v);
+#endif
+};
+
+#ifdef TOUCH_POINT_KERNELS_SSE2
+inline float TouchPointKernels::horizontalSum(__m128 v)
+{
+    __m128 shuffled = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(v, shuffled);
+    shuffled = _mm_movehl_ps(shuffled, sums);
+    sums = _mm_add_ss(sums, shuffled);
+    return _mm_cvtss_f32(sums);
+}
+#endif
+
+inline void TouchPointKernels::centroid(const float *x, const float *y, int count, float &cx, float &cy)
+{
+    cx = 0;
+    cy = 0;
+    if (count <= 0)
+        return;
+
+    float sumX = 0;
+    float sumY = 0;
+    int i = 0;
+
+#if defined(TOUCH_POINT_KERNELS_SSE2)
+    __m128 vx = _mm_setzero_ps();
+    __m128 vy = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4) {
+        vx = _mm_add_ps(vx, _mm_loadu_ps(x + i));
+        vy = _mm_add_ps(vy, _mm_loadu_ps(y + i));
+    }
+    sumX = horizontalSum(vx);
+    sumY = horizontalSum(vy);
+#elif defined(TOUCH_POINT_KERNELS_NEON)
+    float32x4_t vx = vdupq_n_f32(0);
+    float32x4_t vy = vdupq_n_f32(0);
+    for (; i + 4 <= count; i += 4) {
+        vx = vaddq_f32(vx, vld1q_f32(x + i));
+        vy = vaddq_f32(vy, vld1q_f32(y + i));
+    }
+    sumX = vaddvq_f32(vx);
+    sumY = vaddvq_f32(vy);
+#endif
+
+    for (; i < count; i++) {
+        sumX += x[i];
+        sumY += y[i];
+    }
+
+    cx = sumX / count;
+    cy = sumY / count;
+}
+
+inline float TouchPointKernels::meanRadius(const float *x, const float *y, int count, float cx, float cy)
+{
+    if (count <= 0)
+        return 0;
+
+    float sum = 0;
+    int i = 0;
+
+#if defined(TOUCH_POINT_KERNELS_SSE2)
+    __m128 vcx = _mm_set1_ps(cx);
+    __m128 vcy = _mm_set1_ps(cy);
+    __m128 vsum = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), vcx);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), vcy);
+        __m128 squared = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        vsum = _mm_add_ps(vsum, _mm_sqrt_ps(squared));
+    }
+    sum = horizontalSum(vsum);
+#elif defined(TOUCH_POINT_KERNELS_NEON)
+    float32x4_t vcx = vdupq_n_f32(cx);
+    float32x4_t vcy = vdupq_n_f32(cy);
+    float32x4_t vsum = vdupq_n_f32(0);
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t dx = vsubq_f32(vld1q_f32(x + i), vcx);
+        float32x4_t dy = vsubq_f32(vld1q_f32(y + i), vcy);
+        float32x4_t squared = vmlaq_f32(vmulq_f32(dx, dx), dy, dy);
+        vsum = vaddq_f32(vsum, vsqrtq_f32(squared));
+    }
+    sum = vaddvq_f32(vsum);
+#endif
+
+    for (; i < count; i++) {
+        float dx = x[i] - cx;
+        float dy = y[i] - cy;
+        sum += std::sqrt(dx * dx + dy * dy);
+    }
+
+    return sum / count;
+}
+
+inline void TouchPointKernels::covariance(const float *x, const float *y, int count, float cx, float cy,
+                                          float &xx, float &yy, float &xy)
+{
+    xx = 0;
+    yy = 0;
+    xy = 0;
+    if (count <= 0)
+        return;
+
+    float sumXX = 0;
+    float sumYY = 0;
+    float sumXY = 0;
+    int i = 0;
+
+#if defined(TOUCH_POINT_KERNELS_SSE2)
+    __m128 vcx = _mm_set1_ps(cx);
+    __m128 vcy = _mm_set1_ps(cy);
+    __m128 vxx = _mm_setzero_ps();
+    __m128 vyy = _mm_setzero_ps();
+    __m128 vxy = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), vcx);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), vcy);
+        vxx = _mm_add_ps(vxx, _mm_mul_ps(dx, dx));
+        vyy = _mm_add_ps(vyy, _mm_mul_ps(dy, dy));
+        vxy = _mm_add_ps(vxy, _mm_mul_ps(dx, dy));
+    }
+    sumXX = horizontalSum(vxx);
+    sumYY = horizontalSum(vyy);
+    sumXY = horizontalSum(vxy);
+#elif defined(TOUCH_POINT_KERNELS_NEON)
+    float32x4_t vcx = vdupq_n_f32(cx);
+    float32x4_t vcy = vdupq_n_f32(cy);
+    float32x4_t vxx = vdupq_n_f32(0);
+    float32x4_t vyy = vdupq_n_f32(0);
+    float32x4_t vxy = vdupq_n_f32(0);
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t dx = vsubq_f32(vld1q_f32(x + i), vcx);
+        float32x4_t dy = vsubq_f32(vld1q_f32(y + i), vcy);
+        vxx = vmlaq_f32(vxx, dx, dx);
+        vyy = vmlaq_f32(vyy, dy, dy);
+        vxy = vmlaq_f32(vxy, dx, dy);
+    }
+    sumXX = vaddvq_f32(vxx);
+    sumYY = vaddvq_f32(vyy);
+    sumXY = vaddvq_f32(vxy);
+#endif
+
+    for (; i < count; i++) {
+        float dx = x[i] - cx;
+        float dy = y[i] - cy;
+        sumXX += dx * dx;
+        sumYY += dy * dy;
+        sumXY += dx * dy;
+    }
+
+    xx = sumXX / count;
+    yy = sumYY / count;
+    xy = sumXY / count;
+}
+
+inline float TouchPointKernels::spread(const float *x, const float *y, int count)
+{
+    float cx, cy;
+    centroid(x, y, count, cx, cy);
+
+    float xx, yy, xy;
+    covariance(x, y, count, cx, cy, xx, yy, xy);
+
+    // the trace of covariance is the mean squared distance to the centroid.
+    return 2 * std::sqrt(xx + yy);
+}
+
+inline float TouchPointKernels::rotation(const float *x0, const float *y0, const float *x1, const float *y1, int count)
+{
+    if (count < 2)
+        return 0;
+
+    float cx0, cy0, cx1, cy1;
+    centroid(x0, y0, count, cx0, cy0);
+    centroid(x1, y1, count, cx1, cy1);
+
+    // the least squares rotation of the centered points, which is the angle
+    // of the sum of cross and dot products.
+    float cross = 0;
+    float dot = 0;
+    int i = 0;
+
+#if defined(TOUCH_POINT_KERNELS_SSE2)
+    __m128 vcx0 = _mm_set1_ps(cx0);
+    __m128 vcy0 = _mm_set1_ps(cy0);
+    __m128 vcx1 = _mm_set1_ps(cx1);
+    __m128 vcy1 = _mm_set1_ps(cy1);
+    __m128 vcross = _mm_setzero_ps();
+    __m128 vdot = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4) {
+        __m128 dx0 = _mm_sub_ps(_mm_loadu_ps(x0 + i), vcx0);
+        __m128 dy0 = _mm_sub_ps(_mm_loadu_ps(y0 + i), vcy0);
+        __m128 dx1 = _mm_sub_ps(_mm_loadu_ps(x1 + i), vcx1);
+        __m128 dy1 = _mm_sub_ps(_mm_loadu_ps(y1 + i), vcy1);
+        vcross = _mm_add_ps(vcross, _mm_sub_ps(_mm_mul_ps(dx0, dy1), _mm_mul_ps(dy0, dx1)));
+        vdot = _mm_add_ps(vdot, _mm_add_ps(_mm_mul_ps(dx0, dx1), _mm_mul_ps(dy0, dy1)));
+    }
+    cross = horizontalSum(vcross);
+    dot = horizontalSum(vdot);
+#elif defined(TOUCH_POINT_KERNELS_NEON)
+    float32x4_t vcx0 = vdupq_n_f32(cx0);
+    float32x4_t vcy0 = vdupq_n_f32(cy0);
+    float32x4_t vcx1 = vdupq_n_f32(cx1);
+    float32x4_t vcy1 = vdupq_n_f32(cy1);
+    float32x4_t vcross = vdupq_n_f32(0);
+    float32x4_t vdot = vdupq_n_f32(0);
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t dx0 = vsubq_f32(vld1q_f32(x0 + i), vcx0);
+        float32x4_t dy0 = vsubq_f32(vld1q_f32(y0 + i), vcy0);
+        float32x4_t dx1 = vsubq_f32(vld1q_f32(x1 + i), vcx1);
+        float32x4_t dy1 = vsubq_f32(vld1q_f32(y1 + i), vcy1);
+        vcross = vmlsq_f32(vmlaq_f32(vcross, dx0, dy1), dy0, dx1);
+        vdot = vmlaq_f32(vmlaq_f32(vdot, dx0, dx1), dy0, dy1);
+    }
+    cross = vaddvq_f32(vcross);
+    dot = vaddvq_f32(vdot);
+#endif
+
+    for (; i < count; i++) {
+        float dx0 = x0[i] - cx0;
+        float dy0 = y0[i] - cy0;
+        float dx1 = x1[i] - cx1;
+        float dy1 = y1[i] - cy1;
+        cross += dx0 * dy1 - dy0 * dx1;
+        dot += dx0 * dx1 + dy0 * dy1;
+    }
+
+    if (cross == 0 && dot == 0)
+        return 0;
+
+    return std::atan2(cross, dot);
+}
+
+#endif // TOUCHPOINTKERNELS_H
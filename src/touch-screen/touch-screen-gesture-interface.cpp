@@ -24,12 +24,20 @@
 
 #include "touch-screen-gesture-manager.h"
 
-TouchScreenGestureInterface::TouchScreenGestureInterface(QObject *parent) : QObject(parent)
+TouchScreenGestureInterface::TouchScreenGestureInterface(TouchScreenGestureManager *manager)
 {
-    TouchScreenGestureManager::getManager()->registerGesuture(this);
+    if (manager)
+        manager->registerGesuture(this);
 }
 
-int TouchScreenGestureInterface::getGestureIndex()
+bool TouchScreenGestureInterface::acceptsEvent(TouchFrame::EventType type, int fingerCount)
 {
-    return TouchScreenGestureManager::getManager()->queryGestureIndex(this);
+    switch (type) {
+    case TouchFrame::Frame:
+        return fingerCount == finger();
+    case TouchFrame::Up:
+        return fingerCount < finger();
+    default:
+        return true;
+    }
 }
@@ -25,11 +25,36 @@
 
 #include <QObject>
 
-#include <libinput.h>
+#include "touch-frame.h"
 
-class TouchScreenGestureInterface : public QObject
+class TouchScreenGestureManager;
+
+/*!
+ * \brief The TouchScreenGestureSink class
+ * receives the results of the recognizers by direct calls in the input
+ * thread. The index is the one given to the gesture at registration.
+ */
+class TouchScreenGestureSink
 {
-    Q_OBJECT
+public:
+    virtual ~TouchScreenGestureSink() {}
+
+    virtual void onGestureBegin(int index) = 0;
+    virtual void onGestureUpdated(int index) = 0;
+    virtual void onGestureCancelled(int index) = 0;
+    virtual void onGestureFinished(int index) = 0;
+};
+
+/*!
+ * \brief The TouchScreenGestureInterface class
+ * is the plain C++ core of a recognizer. It is not a QObject, the results
+ * are passed to its sink without the meta-object system, see
+ * TouchScreenGestureSignalAdapter for the Qt signals of them.
+ */
+class TouchScreenGestureInterface
+{
+    Q_GADGET
+    friend class TouchScreenGestureManager;
 public:
     enum GestureType {
         Unknown,
@@ -37,7 +62,12 @@ public:
         Zoom,
         Tap,
         DragAndTap,
-        Edge
+        Edge,
+        Rotate,
+        Flick,
+        Hold,
+        DoubleTap,
+        TripleTap
     };
     Q_ENUM(GestureType)
 
@@ -48,7 +78,9 @@ public:
         Up,
         Down,
         ZoomIn,
-        ZoomOut
+        ZoomOut,
+        RotateClockwise,
+        RotateCounterClockwise
     };
     Q_ENUM(Direction)
 
@@ -57,41 +89,79 @@ public:
         Maybe,
         Update,
         Cancelled,
-        Pending,  // gesture action will real execute when all finger released.
+        Pending,  // the total direction is sure, the action can be executed before all finger released.
         Finished
     };
     Q_ENUM(State)
 
-    explicit TouchScreenGestureInterface(QObject *parent = nullptr);
+    /*!
+     * \param manager the gesture is registered into it, which owns the
+     * gesture and is the sink of it.
+     */
+    explicit TouchScreenGestureInterface(TouchScreenGestureManager *manager = nullptr);
+    virtual ~TouchScreenGestureInterface() {}
 
     virtual int finger() = 0;
 
     virtual GestureType type() = 0;
 
-    virtual State handleInputEvent(libinput_event *event) {return Ignore;}
+    /*!
+     * \brief handleInputEvent
+     * \param frame the snapshot of touch points, updated by current event.
+     */
+    virtual State handleInputEvent(const TouchFrame &frame) {return Ignore;}
+
+    /*!
+     * \brief acceptsEvent
+     * \return if the events of this type and finger count can affect the
+     * gesture. The manager builds its dispatch table from it, the default is
+     * the frame events of finger() fingers, the up events below finger()
+     * fingers, and all the other events.
+     */
+    virtual bool acceptsEvent(TouchFrame::EventType type, int fingerCount);
 
     virtual Direction totalDirection() {return None;}
 
     virtual Direction lastDirection() {return None;}
 
+    /*!
+     * \brief lastDelta
+     * \return how far the last update moved, in mm, or in degrees for a
+     * rotation. 0 if the gesture doesn't measure it, and then every update
+     * is a step of the update bindings.
+     */
+    virtual double lastDelta() {return 0;}
+
     virtual void reset() {}
 
     virtual bool isCancelled() {return false;}
     virtual void cancel() {} // using to cancel some gesture, if it is cancellable.
 
+    TouchScreenGestureSink *sink() const {return m_sink;}
+    /*!
+     * \brief setSink
+     * replace the sink which is set by the manager, the new one should pass
+     * the results to the manager too.
+     */
+    void setSink(TouchScreenGestureSink *sink) {m_sink = sink;}
+
 protected:
 
     /*!
      * \brief getGestureIndex
-     * \return an int value from touch screen gesture manager
+     * \return the index given by touch screen gesture manager at
+     * registration, or -1 if it is not registered.
      */
-    int getGestureIndex();
+    int getGestureIndex() const {return m_index;}
+
+    void gestureBegin() {if (m_sink) m_sink->onGestureBegin(m_index);}
+    void gestureUpdate() {if (m_sink) m_sink->onGestureUpdated(m_index);}
+    void gestureCancelled() {if (m_sink) m_sink->onGestureCancelled(m_index);}
+    void gestureFinished() {if (m_sink) m_sink->onGestureFinished(m_index);}
 
-signals:
-    void gestureBegin(int registedIndex);
-    void gestureUpdate(int registedIndex);
-    void gestureCancelled(int registedIndex);
-    void gestureFinished(int registedIndex);
+private:
+    int m_index = -1;
+    TouchScreenGestureSink *m_sink = nullptr;
 };
 
 #endif // TOUCHSCREENGESTUREINTERFACE_H
@@ -26,98 +26,477 @@
 
 #include "settings-manager.h"
 #include "uinput-helper.h"
+#include "latency-tracker.h"
 
+#include "touch-screen-multi-finger-flick-gesture.h"
+#include "touch-screen-multi-finger-hold-gesture.h"
+#include "touch-screen-multi-finger-rotate-gesture.h"
+#include "touch-screen-multi-finger-swipe-gesture.h"
+#include "touch-screen-multi-finger-tap-gesture.h"
+#include "touch-screen-multi-finger-zoom-gesture.h"
 #include "touch-screen-two-finger-swipe-gesture.h"
+#include "touch-screen-two-finger-drag-and-tap-gesture.h"
 
+#include "touch-screen-one-finger-edge-gesture.h"
+
+#include <QMetaEnum>
+#include <QtAlgorithms>
 #include <QDebug>
 
-static TouchScreenGestureManager *instance = nullptr;
+#include <string.h>
+
+#define GESTURE_TYPE_BIT(type) (1u << TouchScreenGestureInterface::type)
 
-TouchScreenGestureManager::TouchScreenGestureManager(QObject *parent) : QObject(parent)
+// the gesture types which lose when a gesture of the type updates, unless
+// they are configured in group "conflicts". The first one of zoom and
+// rotate updated wins.
+static const struct {
+    TouchScreenGestureInterface::GestureType type;
+    quint32 conflicts;
+} default_conflicts[] = {
+    {TouchScreenGestureInterface::Swipe, GESTURE_TYPE_BIT(DragAndTap)},
+    {TouchScreenGestureInterface::Zoom, GESTURE_TYPE_BIT(Swipe) | GESTURE_TYPE_BIT(Rotate) | GESTURE_TYPE_BIT(DragAndTap)},
+    {TouchScreenGestureInterface::Rotate, GESTURE_TYPE_BIT(Swipe) | GESTURE_TYPE_BIT(Zoom) | GESTURE_TYPE_BIT(DragAndTap)},
+};
+
+TouchScreenGestureManager::TouchScreenGestureManager(const QString &deviceName, UInputHelper *output, QObject *parent) : QObject(parent),
+    m_kineticScroller(output)
 {
+    m_deviceName = deviceName;
+    m_output = output;
+}
 
+TouchScreenGestureManager::~TouchScreenGestureManager()
+{
+    qDeleteAll(m_gestures);
 }
 
-TouchScreenGestureManager *TouchScreenGestureManager::getManager()
+void TouchScreenGestureManager::createGestures()
 {
-    if (!instance)
-        instance = new TouchScreenGestureManager;
-    return instance;
+    // init gesutre and register into this manager
+    new TouchScreenThreeFingerSwipeGesture(this);
+    new TouchScreenFourFingerSwipeGesture(this);
+    new TouchScreenFiveFingerSwipeGesture(this);
+    new TouchScreenThreeFingerZoomGesture(this);
+    new TouchScreenFourFingerZoomGesture(this);
+    new TouchScreenFiveFingerZoomGesture(this);
+    new TouchScreenOneFingerTapGesture(this);
+    new TouchScreenTwoFingerTapGesture(this);
+    new TouchScreenThreeFingerTapGesture(this);
+    new TouchScreenFourFingerTapGesture(this);
+    new TouchScreenFiveFingerTapGesture(this);
+    new TouchScreenTwoFingerSwipeGesture(this);
+    new TouchScreenTwoFingerZoomGesture(this);
+    new TouchScreenTwoFingerDragAndTapGesture(this);
+
+    new TouchScreenTwoFingerRotateGesture(this);
+    new TouchScreenThreeFingerRotateGesture(this);
+    new TouchScreenFourFingerRotateGesture(this);
+    new TouchScreenFiveFingerRotateGesture(this);
+
+    // gestures of more fingers, for the large panels.
+    new TouchScreenMultiFingerSwipeGesture<6>(this);
+    new TouchScreenMultiFingerSwipeGesture<7>(this);
+    new TouchScreenMultiFingerSwipeGesture<8>(this);
+    new TouchScreenMultiFingerSwipeGesture<9>(this);
+    new TouchScreenMultiFingerSwipeGesture<10>(this);
+    new TouchScreenMultiFingerZoomGesture<6>(this);
+    new TouchScreenMultiFingerZoomGesture<7>(this);
+    new TouchScreenMultiFingerZoomGesture<8>(this);
+    new TouchScreenMultiFingerZoomGesture<9>(this);
+    new TouchScreenMultiFingerZoomGesture<10>(this);
+
+    new TouchScreenOneFingerEdgeGesture(this);
+
+    // after the swipes, so a flick is only finished if no swipe is.
+    new TouchScreenTwoFingerFlickGesture(this);
+    new TouchScreenThreeFingerFlickGesture(this);
+    new TouchScreenFourFingerFlickGesture(this);
+    new TouchScreenFiveFingerFlickGesture(this);
+
+    // finished by their own timers while the fingers are still down.
+    new TouchScreenOneFingerHoldGesture(this);
+    new TouchScreenTwoFingerHoldGesture(this);
+    new TouchScreenThreeFingerHoldGesture(this);
+    new TouchScreenFourFingerHoldGesture(this);
+    new TouchScreenFiveFingerHoldGesture(this);
 }
 
 int TouchScreenGestureManager::registerGesuture(TouchScreenGestureInterface *gesture)
 {
+    if (m_gestures.count() == TOUCH_SCREEN_MAX_GESTURES)
+        qWarning()<<m_deviceName<<"too many gestures, the events will not be dispatched to"<<gesture;
+
+    // the index never changes, the gestures are not unregistered.
+    gesture->m_index = m_gestures.count();
+    gesture->m_sink = this;
     m_gestures<<gesture;
-    connect(gesture, &TouchScreenGestureInterface::gestureBegin, this, &TouchScreenGestureManager::onGestureBegin);
-    connect(gesture, &TouchScreenGestureInterface::gestureUpdate, this, &TouchScreenGestureManager::onGestureUpdated);
-    connect(gesture, &TouchScreenGestureInterface::gestureCancelled, this, &TouchScreenGestureManager::onGestureCancelled);
-    connect(gesture, &TouchScreenGestureInterface::gestureFinished, this, &TouchScreenGestureManager::onGestureFinished);
-    return m_gestures.indexOf(gesture);
+    m_isDispatchTableDirty = true;
+    return gesture->m_index;
 }
 
 int TouchScreenGestureManager::queryGestureIndex(TouchScreenGestureInterface *gesture)
 {
-    return m_gestures.indexOf(gesture);
+    return gesture->m_index;
 }
 
 void TouchScreenGestureManager::processEvent(libinput_event *event)
 {
-    for (auto gesture : m_gestures) {
-        auto state = gesture->handleInputEvent(event);
-        //qDebug()<<gesture->finger()<<state;
+    // decode the event only once for all gestures.
+    if (m_decoder.decode(event))
+        processFrame(m_decoder.frame());
+}
+
+void TouchScreenGestureManager::processFrame(const TouchFrame &frame)
+{
+    // the gestures are triggered synchronously by this frame.
+    m_eventTime = frame.time;
+    if (m_isDispatchTableDirty)
+        buildDispatchTable();
+
+    // any touch stops the scrolling at once.
+    if (frame.type == TouchFrame::Down) {
+        m_kineticScroller.stop();
+        // the cached settings only change between touch sequences.
+        if (frame.fingerCount == 1 && !m_isCommitted && m_settingsGeneration != SettingsManager::getManager()->generation())
+            loadSettings();
+    }
+
+    if (m_isCommitted) {
+        // the gesture has been executed, wait for all fingers released.
+        if (frame.fingerCount == 0 && (frame.type == TouchFrame::Up || frame.type == TouchFrame::Cancel)) {
+            m_isCommitted = false;
+            forceReset();
+        }
+        return;
+    }
+
+    int fingerCount = qBound(0, frame.fingerCount, TOUCH_FRAME_MAX_SLOTS);
+    int pending = dispatchFrame(frame, m_candidates & m_dispatchTable[frame.type][fingerCount]);
+
+    if (pending >= 0 && m_isEarlyCommitEnabled && fingerCount > 0 && canCommit(pending, fingerCount)) {
+        commit(pending);
+        return;
+    }
+
+    if (frame.type == TouchFrame::Down) {
+        // the gestures of less fingers have cancelled themselves by this event.
+        m_candidates &= m_fingerMasks[fingerCount];
+    }
+
+    if (frame.fingerCount == 0) {
+        if (frame.type == TouchFrame::Cancel) {
+            // there will be no touch up event after a cancelled touch.
+            forceReset();
+        } else if (frame.type == TouchFrame::Up) {
+            // the pruned gestures didn't see the last touch up event.
+            quint64 pruned = m_touchedGestures & ~m_candidates;
+            m_touchedGestures &= ~pruned;
+            while (pruned) {
+                int index = qCountTrailingZeroBits(pruned);
+                pruned &= pruned - 1;
+                m_gestures.at(index)->reset();
+            }
+            m_candidates = m_allGestures;
+            resetUpdateStream();
+        }
     }
 }
 
 void TouchScreenGestureManager::forceReset()
 {
-    for (auto gesture : m_gestures) {
-        gesture->reset();
+    resetTouchedGestures();
+    m_candidates = m_allGestures;
+    m_kineticScroller.stop();
+    resetUpdateStream();
+}
+
+void TouchScreenGestureManager::buildDispatchTable()
+{
+    memset(m_dispatchTable, 0, sizeof(m_dispatchTable));
+    memset(m_fingerMasks, 0, sizeof(m_fingerMasks));
+    m_allGestures = 0;
+
+    auto tracker = LatencyTracker::getTracker();
+    auto types = QMetaEnum::fromType<TouchScreenGestureInterface::GestureType>();
+
+    int count = qMin(m_gestures.count(), TOUCH_SCREEN_MAX_GESTURES);
+    for (int index = 0; index < count; index++) {
+        auto gesture = m_gestures.at(index);
+        quint64 bit = Q_UINT64_C(1) << index;
+        m_allGestures |= bit;
+        // the managers of a thread share the histogram of a name.
+        QString name = QString("touch screen %1 finger %2").arg(gesture->finger()).arg(types.valueToKey(gesture->type()));
+        m_latencyHistograms[index] = tracker->registerHistogram(name);
+        for (int fingerCount = 0; fingerCount <= TOUCH_FRAME_MAX_SLOTS; fingerCount++) {
+            if (gesture->finger() >= fingerCount)
+                m_fingerMasks[fingerCount] |= bit;
+            for (int type = TouchFrame::Down; type <= TouchFrame::Cancel; type++) {
+                if (gesture->acceptsEvent(TouchFrame::EventType(type), fingerCount))
+                    m_dispatchTable[type][fingerCount] |= bit;
+            }
+        }
     }
+
+    // the gestures are registered before the first touch event.
+    m_candidates = m_allGestures;
+    m_isDispatchTableDirty = false;
+
+    loadSettings();
 }
 
-void TouchScreenGestureManager::onGestureBegin(int index)
+void TouchScreenGestureManager::loadSettings()
 {
+    auto settingsManager = SettingsManager::getManager();
+    m_settingsGeneration = settingsManager->generation();
+    m_isEarlyCommitEnabled = settingsManager->isEarlyCommitEnabled();
+    // the scrolling is stopped by the touch which reloads it.
+    m_kineticScroller.setProfile(settingsManager->kineticScrollProfile());
 
+    buildConflictMasks();
+    buildUpdateBindings();
+    buildFinishedBindings();
 }
 
-void TouchScreenGestureManager::onGestureUpdated(int index)
+void TouchScreenGestureManager::buildConflictMasks()
 {
-    auto gesture = m_gestures.at(index);
-    qDebug()<<gesture->finger()<<"finger"<<gesture->type()<<"updated, current direction:"<<gesture->lastDirection();
+    auto settingsManager = SettingsManager::getManager();
 
+    // the types lose to each type, as bits of the gesture types.
+    quint32 typeConflicts[32] = {};
+    quint32 types = 0;
+    int count = qMin(m_gestures.count(), TOUCH_SCREEN_MAX_GESTURES);
+    for (int index = 0; index < count; index++) {
+        types |= 1u << m_gestures.at(index)->type();
+    }
+    while (types) {
+        int type = qCountTrailingZeroBits(types);
+        types &= types - 1;
+        quint32 conflicts = 0;
+        for (auto entry : default_conflicts) {
+            if (entry.type == type)
+                conflicts = entry.conflicts;
+        }
+        typeConflicts[type] = settingsManager->getConflicts(TouchScreenGestureInterface::GestureType(type), conflicts);
+    }
 
-    // cancel swipe gesture if any zoom gesture triggered.
-    if (gesture->type() == TouchScreenGestureInterface::Zoom) {
-        for (auto gesture : m_gestures) {
-            if (gesture->type() == TouchScreenGestureInterface::Swipe) {
-                gesture->cancel();
-            }
+    for (int index = 0; index < count; index++) {
+        quint32 conflicts = typeConflicts[m_gestures.at(index)->type()];
+        m_conflictMasks[index] = 0;
+        for (int other = 0; other < count; other++) {
+            if (other != index && (conflicts & (1u << m_gestures.at(other)->type())))
+                m_conflictMasks[index] |= Q_UINT64_C(1) << other;
         }
-        if (gesture->finger() == 2) {
-            UInputHelper::getInstance()->executeShortCut(gesture->lastDirection() == TouchScreenGestureInterface::ZoomIn? QKeySequence("Ctrl++"): QKeySequence("Ctrl+-"));
+    }
+}
+
+void TouchScreenGestureManager::buildUpdateBindings()
+{
+    auto settingsManager = SettingsManager::getManager();
+    int count = qMin(m_gestures.count(), TOUCH_SCREEN_MAX_GESTURES);
+    for (int index = 0; index < count; index++) {
+        auto gesture = m_gestures.at(index);
+        UpdateBinding &binding = m_updateBindings[index];
+        for (int direction = TouchScreenGestureInterface::None; direction <= TouchScreenGestureInterface::RotateCounterClockwise; direction++) {
+            binding.shortCuts[direction] = settingsManager->getShortCut(gesture, TouchScreenGestureInterface::Update,
+                                                                       TouchScreenGestureInterface::Direction(direction));
         }
-    } else {
-        if (gesture->finger() == 2) {
-            if (gesture->type() == TouchScreenGestureInterface::Swipe) {
-                auto twoFingerSwipe = static_cast<TouchScreenTwoFingerSwipeGesture *>(gesture);
-                auto offset = twoFingerSwipe->getLastOffset();
-                UInputHelper::getInstance()->wheel(offset/10);
+        binding.step = settingsManager->getUpdateStep(gesture->type(), gesture->finger());
+    }
+}
+
+void TouchScreenGestureManager::buildFinishedBindings()
+{
+    auto settingsManager = SettingsManager::getManager();
+    int count = qMin(m_gestures.count(), TOUCH_SCREEN_MAX_GESTURES);
+    for (int index = 0; index < count; index++) {
+        auto gesture = m_gestures.at(index);
+        FinishedBinding &binding = m_finishedBindings[index];
+        for (int direction = TouchScreenGestureInterface::None; direction <= TouchScreenGestureInterface::RotateCounterClockwise; direction++) {
+            auto shortCut = settingsManager->getShortCut(gesture, TouchScreenGestureInterface::Finished,
+                                                         TouchScreenGestureInterface::Direction(direction));
+            // a flick is a short swipe, unless it is bound by itself.
+            if (shortCut.isEmpty() && gesture->type() == TouchScreenGestureInterface::Flick) {
+                shortCut = settingsManager->getShortCut(TouchScreenGestureInterface::Swipe, gesture->finger(), TouchScreenGestureInterface::Finished,
+                                                        TouchScreenGestureInterface::Direction(direction));
             }
+            binding.shortCuts[direction] = shortCut;
+        }
+
+        binding.doubleTapShortCut = QKeySequence();
+        binding.tripleTapShortCut = QKeySequence();
+        if (gesture->type() == TouchScreenGestureInterface::Tap) {
+            binding.doubleTapShortCut = settingsManager->getShortCut(TouchScreenGestureInterface::DoubleTap, gesture->finger(),
+                                                                     TouchScreenGestureInterface::Finished, TouchScreenGestureInterface::None);
+            binding.tripleTapShortCut = settingsManager->getShortCut(TouchScreenGestureInterface::TripleTap, gesture->finger(),
+                                                                     TouchScreenGestureInterface::Finished, TouchScreenGestureInterface::None);
         }
     }
+}
 
-    if (gesture->type() == TouchScreenGestureInterface::Swipe || gesture->type() == TouchScreenGestureInterface::Zoom) {
-        // cancel drag and tap gesture
-        for (auto gesture : m_gestures) {
-            if (gesture->type() == TouchScreenGestureInterface::DragAndTap) {
-                gesture->cancel();
-            }
+QKeySequence TouchScreenGestureManager::finishedShortCut(int index)
+{
+    if (index < 0 || index >= TOUCH_SCREEN_MAX_GESTURES)
+        return QKeySequence();
+
+    auto gesture = m_gestures.at(index);
+    const FinishedBinding &binding = m_finishedBindings[index];
+    switch (gesture->type()) {
+    case TouchScreenGestureInterface::DoubleTap:
+        return binding.doubleTapShortCut;
+    case TouchScreenGestureInterface::TripleTap:
+        return binding.tripleTapShortCut;
+    default:
+        return binding.shortCuts[gesture->totalDirection()];
+    }
+}
+
+int TouchScreenGestureManager::dispatchFrame(const TouchFrame &frame, quint64 gestures)
+{
+    int pending = -1;
+
+    // in the order of registration, same as the gesture indexes.
+    while (gestures) {
+        int index = qCountTrailingZeroBits(gestures);
+        gestures &= gestures - 1;
+        m_touchedGestures |= Q_UINT64_C(1) << index;
+        auto state = m_gestures.at(index)->handleInputEvent(frame);
+        if (state == TouchScreenGestureInterface::Cancelled)
+            m_candidates &= ~(Q_UINT64_C(1) << index);
+        else if (state == TouchScreenGestureInterface::Pending && pending < 0)
+            pending = index;
+    }
+
+    return pending;
+}
+
+void TouchScreenGestureManager::cancelConflicts(int index)
+{
+    if (index >= TOUCH_SCREEN_MAX_GESTURES)
+        return;
+
+    quint64 conflicts = m_candidates & m_conflictMasks[index];
+    m_candidates &= ~conflicts;
+    // they are reset after cancelled, as if they saw the input.
+    m_touchedGestures |= conflicts;
+    while (conflicts) {
+        int conflict = qCountTrailingZeroBits(conflicts);
+        conflicts &= conflicts - 1;
+        m_gestures.at(conflict)->cancel();
+    }
+}
+
+void TouchScreenGestureManager::resetTouchedGestures()
+{
+    // the others are reset already.
+    quint64 touched = m_touchedGestures;
+    m_touchedGestures = 0;
+    while (touched) {
+        int index = qCountTrailingZeroBits(touched);
+        touched &= touched - 1;
+        m_gestures.at(index)->reset();
+    }
+}
+
+bool TouchScreenGestureManager::canCommit(int index, int fingerCount)
+{
+    quint64 competitors = m_candidates & ~(Q_UINT64_C(1) << index);
+    while (competitors) {
+        int competitor = qCountTrailingZeroBits(competitors);
+        competitors &= competitors - 1;
+        auto gesture = m_gestures.at(competitor);
+        if (gesture->finger() == fingerCount && !gesture->isCancelled() && gesture->lastDirection() != TouchScreenGestureInterface::None)
+            return false;
+    }
+    return true;
+}
+
+void TouchScreenGestureManager::commit(int index)
+{
+    auto gesture = m_gestures.at(index);
+    qDebug()<<m_deviceName<<gesture->finger()<<"finger"<<gesture->type()<<"committed before released";
+
+    // all gestures are reset by it, and see no more event of this sequence.
+    onGestureFinished(index);
+    m_candidates = 0;
+    m_isCommitted = true;
+}
+
+void TouchScreenGestureManager::onGestureBegin(int index)
+{
+
+}
+
+void TouchScreenGestureManager::onGestureUpdated(int index)
+{
+    auto gesture = m_gestures.at(index);
+    qDebug()<<m_deviceName<<gesture->finger()<<"finger"<<gesture->type()<<"updated, current direction:"<<gesture->lastDirection();
+
+    // the built-in actions are only taken if the gesture is not bound.
+    bool isBound = executeUpdateBinding(index);
+
+    // the conflicting gestures lose, see default_conflicts.
+    cancelConflicts(index);
+
+    if (gesture->type() == TouchScreenGestureInterface::Zoom) {
+        if (gesture->finger() == 2 && !isBound) {
+            m_output->executeShortCut(gesture->lastDirection() == TouchScreenGestureInterface::ZoomIn? QKeySequence("Ctrl++"): QKeySequence("Ctrl+-"));
+            recordLatency(gesture);
         }
+    } else if (gesture->type() == TouchScreenGestureInterface::Swipe && gesture->finger() == 2) {
+        auto twoFingerSwipe = static_cast<TouchScreenTwoFingerSwipeGesture *>(gesture);
+        auto offset = twoFingerSwipe->getLastOffset();
+        m_output->wheel(offset/10);
+        recordLatency(gesture);
     }
 
     if (gesture->type() == TouchScreenGestureInterface::DragAndTap) {
-        UInputHelper::getInstance()->clickMouseRightButton();
+        m_output->clickMouseRightButton();
+        recordLatency(gesture);
+    }
+}
+
+bool TouchScreenGestureManager::executeUpdateBinding(int index)
+{
+    if (index < 0 || index >= TOUCH_SCREEN_MAX_GESTURES)
+        return false;
+
+    auto gesture = m_gestures.at(index);
+    auto direction = gesture->lastDirection();
+    const UpdateBinding &binding = m_updateBindings[index];
+    const QKeySequence &shortCut = binding.shortCuts[direction];
+    if (shortCut.isEmpty())
+        return false;
+
+    // the distance is counted again when the gesture or direction changed.
+    if (m_streamGesture != index || m_streamDirection != direction) {
+        m_streamGesture = index;
+        m_streamDirection = direction;
+        m_streamDistance = 0;
+    }
+
+    int steps = 1;
+    double step = binding.step;
+    if (step > 0 && gesture->lastDelta() > 0) {
+        m_streamDistance += gesture->lastDelta();
+        steps = int(m_streamDistance / step);
+        m_streamDistance -= steps * step;
+    }
+
+    for (int i = 0; i < steps; i++) {
+        m_output->executeShortCut(shortCut);
     }
+    if (steps > 0)
+        recordLatency(gesture);
+
+    return true;
+}
+
+void TouchScreenGestureManager::resetUpdateStream()
+{
+    m_streamGesture = -1;
+    m_streamDirection = TouchScreenGestureInterface::None;
+    m_streamDistance = 0;
 }
 
 void TouchScreenGestureManager::onGestureCancelled(int index)
@@ -128,21 +507,45 @@ void TouchScreenGestureManager::onGestureCancelled(int index)
 void TouchScreenGestureManager::onGestureFinished(int index)
 {
     auto gesture = m_gestures.at(index);
-    qDebug()<<gesture->finger()<<"finger"<<gesture->type()<<"finished, total direction:"<<gesture->totalDirection();
+    qDebug()<<m_deviceName<<gesture->finger()<<"finger"<<gesture->type()<<"finished, total direction:"<<gesture->totalDirection();
 
-    if (gesture->type() == TouchScreenGestureInterface::Tap) {
-        if (gesture->finger() == 2)
-            UInputHelper::getInstance()->clickMouseRightButton();
+    auto shortCut = finishedShortCut(index);
+    if (gesture->type() == TouchScreenGestureInterface::Tap && gesture->finger() == 2 && shortCut.isEmpty()) {
+        // a two finger tap is a right click, unless it is bound.
+        m_output->clickMouseRightButton();
+        recordLatency(gesture);
     } else {
-        auto settingsManager = SettingsManager::getManager();
-        auto shortCut = settingsManager->getShortCut(gesture, TouchScreenGestureInterface::Finished, gesture->totalDirection());
-        qDebug()<<shortCut;
+        // an unbound hold must not interrupt the gestures going on.
+        if (shortCut.isEmpty() && gesture->type() == TouchScreenGestureInterface::Hold)
+            return;
+
+        m_output->executeShortCut(shortCut);
+        // a hold is finished by the timer, not by an input event.
+        if (!shortCut.isEmpty() && gesture->type() != TouchScreenGestureInterface::Hold)
+            recordLatency(gesture);
 
-        UInputHelper::getInstance()->executeShortCut(shortCut);
+        // the fingers of a bound hold are still down, it is committed like
+        // commit(), so the rest of the sequence is swallowed, and the
+        // gestures are reset by forceReset() when all fingers released.
+        if (gesture->type() == TouchScreenGestureInterface::Hold) {
+            m_candidates = 0;
+            m_isCommitted = true;
+        }
+
+        // keep scrolling after two finger scroll released.
+        if (gesture->type() == TouchScreenGestureInterface::Swipe && gesture->finger() == 2) {
+            auto velocity = static_cast<TouchScreenTwoFingerSwipeGesture *>(gesture)->getReleaseVelocity();
+            m_kineticScroller.fling(velocity.x(), velocity.y());
+        }
     }
 
     // reset all gesture
-    for (auto gesture : m_gestures) {
-        gesture->reset();
-    }
+    resetTouchedGestures();
+}
+
+void TouchScreenGestureManager::recordLatency(TouchScreenGestureInterface *gesture)
+{
+    int index = gesture->getGestureIndex();
+    if (index >= 0 && index < TOUCH_SCREEN_MAX_GESTURES)
+        LatencyTracker::getTracker()->record(m_latencyHistograms[index], m_eventTime);
 }
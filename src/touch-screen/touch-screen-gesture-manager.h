@@ -24,35 +24,160 @@
 #define TOUCHSCREENGESTUREMANAGER_H
 
 #include <QObject>
+#include <QKeySequence>
 
 #include <libinput.h>
 
-class TouchScreenGestureInterface;
+#include "touch-frame.h"
+#include "touch-screen-gesture-interface.h"
+#include "kinetic-scroller.h"
 
-class TouchScreenGestureManager : public QObject
+// the candidates are tracked as a bit mask of the gesture indexes.
+#define TOUCH_SCREEN_MAX_GESTURES 64
+
+class UInputHelper;
+
+/*!
+ * \brief The TouchScreenGestureManager class
+ * owns the recognizers of one touch screen, so the touch points of different
+ * screens are never mixed up. The recognizers register themselves into the
+ * manager which is their parent.
+ *
+ * A touch event is only dispatched to the candidates which can still match,
+ * looked up in a table of the finger count and the event type. The gestures
+ * which need less fingers than the current count, or have been cancelled,
+ * are pruned from the candidates until all fingers are released.
+ *
+ * When a gesture updates, the candidates which conflict with it are pruned
+ * by a mask of the conflict matrix, and only the gestures which have seen
+ * input are reset after a gesture finished.
+ */
+class TouchScreenGestureManager : public QObject, public TouchScreenGestureSink
 {
     friend class TouchScreenGestureInterface;
     Q_OBJECT
 public:
-    static TouchScreenGestureManager *getManager();
+    /*!
+     * \param output the virtual device of the seat, which the gestures
+     * are translated to.
+     */
+    explicit TouchScreenGestureManager(const QString &deviceName, UInputHelper *output, QObject *parent = nullptr);
+    ~TouchScreenGestureManager() override;
+
+    /*!
+     * \brief createGestures
+     * create the default recognizer set of a touch screen.
+     */
+    void createGestures();
+
+    QString deviceName() const {return m_deviceName;}
+
+    void setFilterProfile(const TouchPointFilter::Profile &profile) {m_decoder.setFilterProfile(profile);}
 
     int queryGestureIndex(TouchScreenGestureInterface *gesture);
 
     void processEvent(libinput_event *event);
+    void processFrame(const TouchFrame &frame);
     void forceReset();
-signals:
 
-public slots:
-    void onGestureBegin(int index);
-    void onGestureUpdated(int index);
-    void onGestureCancelled(int index);
-    void onGestureFinished(int index);
+    void onGestureBegin(int index) override;
+    void onGestureUpdated(int index) override;
+    void onGestureCancelled(int index) override;
+    void onGestureFinished(int index) override;
 
 private:
     int registerGesuture(TouchScreenGestureInterface *gesture); // return a index of registered gesture.
 
-    explicit TouchScreenGestureManager(QObject *parent = nullptr);
+    void recordLatency(TouchScreenGestureInterface *gesture);
+
+    /*!
+     * \brief executeUpdateBinding
+     * execute the shortcut bound to the Update state of the gesture, once
+     * for every step distance of settings, or for every update without it.
+     * \return false if the gesture is not bound.
+     */
+    bool executeUpdateBinding(int index);
+    void resetUpdateStream();
+
+    void buildDispatchTable();
+    // read the settings which are cached for the settings generation.
+    void loadSettings();
+    void buildConflictMasks();
+    void buildUpdateBindings();
+    void buildFinishedBindings();
+    // the cached Finished shortcut of the gesture for its type and direction.
+    QKeySequence finishedShortCut(int index);
+    // return the index of the first gesture which is Pending, or -1.
+    int dispatchFrame(const TouchFrame &frame, quint64 gestures);
+
+    /*!
+     * \brief canCommit
+     * \return false if another candidate of the finger count has recognized
+     * a direction too, and might still win against the pending gesture.
+     */
+    bool canCommit(int index, int fingerCount);
+    void commit(int index);
+
+    // cancel the candidates which lose to the updated gesture.
+    void cancelConflicts(int index);
+    void resetTouchedGestures();
+
+    QString m_deviceName;
+    UInputHelper *m_output = nullptr;
     QList<TouchScreenGestureInterface *> m_gestures;
+
+    // the gestures accept the event type with the finger count.
+    quint64 m_dispatchTable[TouchFrame::Cancel + 1][TOUCH_FRAME_MAX_SLOTS + 1] = {};
+    // the gestures need no less fingers than the count.
+    quint64 m_fingerMasks[TOUCH_FRAME_MAX_SLOTS + 1] = {};
+    quint64 m_allGestures = 0;
+    quint64 m_candidates = 0;
+    // the gestures which lose when the gesture of the index updates.
+    quint64 m_conflictMasks[TOUCH_SCREEN_MAX_GESTURES] = {};
+    // the settings generation which the cached settings are read from.
+    int m_settingsGeneration = -1;
+    // the gestures which have seen input or been cancelled since reset.
+    quint64 m_touchedGestures = 0;
+    // the finger() of a gesture is not ready while it is registering.
+    bool m_isDispatchTableDirty = true;
+
+    TouchFrameDecoder m_decoder;
+
+    KineticScroller m_kineticScroller;
+
+    // the pending gestures are finished before all fingers released, it is
+    // cached for the settings generation.
+    bool m_isEarlyCommitEnabled = false;
+    // the rest events of the committed touch sequence are swallowed.
+    bool m_isCommitted = false;
+
+    // the Update shortcuts of each gesture by direction, and the step.
+    struct UpdateBinding {
+        QKeySequence shortCuts[TouchScreenGestureInterface::RotateCounterClockwise + 1];
+        double step = 0;
+    };
+    UpdateBinding m_updateBindings[TOUCH_SCREEN_MAX_GESTURES];
+
+    // the Finished shortcuts of each gesture by direction, a flick falls
+    // back to the swipe of its finger count. The type of a tap follows its
+    // tap count, so the DoubleTap and TripleTap ones are kept for it too.
+    struct FinishedBinding {
+        QKeySequence shortCuts[TouchScreenGestureInterface::RotateCounterClockwise + 1];
+        QKeySequence doubleTapShortCut;
+        QKeySequence tripleTapShortCut;
+    };
+    FinishedBinding m_finishedBindings[TOUCH_SCREEN_MAX_GESTURES];
+
+    // the gesture which the update bindings are executed for.
+    int m_streamGesture = -1;
+    TouchScreenGestureInterface::Direction m_streamDirection = TouchScreenGestureInterface::None;
+    double m_streamDistance = 0;
+
+    // the timestamp of the event which is being handled, in usec.
+    quint64 m_eventTime = 0;
+    // the LatencyTracker index of each gesture, registered with the
+    // dispatch table.
+    int m_latencyHistograms[TOUCH_SCREEN_MAX_GESTURES] = {};
 };
 
 #endif // TOUCHSCREENGESTUREMANAGER_H
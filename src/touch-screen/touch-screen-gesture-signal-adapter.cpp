@@ -0,0 +1,56 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "touch-screen-gesture-signal-adapter.h"
+
+TouchScreenGestureSignalAdapter::TouchScreenGestureSignalAdapter(TouchScreenGestureSink *next, QObject *parent) : QObject(parent)
+{
+    m_next = next;
+}
+
+void TouchScreenGestureSignalAdapter::onGestureBegin(int index)
+{
+    if (m_next)
+        m_next->onGestureBegin(index);
+    emit gestureBegin(index);
+}
+
+void TouchScreenGestureSignalAdapter::onGestureUpdated(int index)
+{
+    if (m_next)
+        m_next->onGestureUpdated(index);
+    emit gestureUpdate(index);
+}
+
+void TouchScreenGestureSignalAdapter::onGestureCancelled(int index)
+{
+    if (m_next)
+        m_next->onGestureCancelled(index);
+    emit gestureCancelled(index);
+}
+
+void TouchScreenGestureSignalAdapter::onGestureFinished(int index)
+{
+    if (m_next)
+        m_next->onGestureFinished(index);
+    emit gestureFinished(index);
+}
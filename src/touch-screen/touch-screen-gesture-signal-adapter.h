@@ -0,0 +1,58 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef TOUCHSCREENGESTURESIGNALADAPTER_H
+#define TOUCHSCREENGESTURESIGNALADAPTER_H
+
+#include <QObject>
+
+#include "touch-screen-gesture-interface.h"
+
+/*!
+ * \brief The TouchScreenGestureSignalAdapter class
+ * turns the results of the recognizers into Qt signals, for the objects
+ * which want them out of the input thread. It is installed by
+ * TouchScreenGestureInterface::setSink(), and passes the results to the
+ * next sink first, usually the manager, so the gestures keep working.
+ */
+class TouchScreenGestureSignalAdapter : public QObject, public TouchScreenGestureSink
+{
+    Q_OBJECT
+public:
+    explicit TouchScreenGestureSignalAdapter(TouchScreenGestureSink *next = nullptr, QObject *parent = nullptr);
+
+    void onGestureBegin(int index) override;
+    void onGestureUpdated(int index) override;
+    void onGestureCancelled(int index) override;
+    void onGestureFinished(int index) override;
+
+signals:
+    void gestureBegin(int registedIndex);
+    void gestureUpdate(int registedIndex);
+    void gestureCancelled(int registedIndex);
+    void gestureFinished(int registedIndex);
+
+private:
+    TouchScreenGestureSink *m_next = nullptr;
+};
+
+#endif // TOUCHSCREENGESTURESIGNALADAPTER_H
@@ -0,0 +1,151 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "touch-screen-multi-finger-flick-gesture.h"
+
+#include "touch-point-kernels.h"
+
+// the speed of the fingers' centroid when the first one is released, in mm/s.
+#define FLICK_MIN_VELOCITY 200
+// the fingers should move a bit, so a tap is not a flick, in mm.
+#define FLICK_MIN_DISTANCE 5
+// from all fingers down to the first one released, in usec.
+#define FLICK_MAX_DURATION 300000
+
+template<int N>
+TouchScreenMultiFingerFlickGesture<N>::TouchScreenMultiFingerFlickGesture(TouchScreenGestureManager *manager) : TouchScreenGestureInterface(manager)
+{
+
+}
+
+template<int N>
+TouchScreenGestureInterface::State TouchScreenMultiFingerFlickGesture<N>::handleInputEvent(const TouchFrame &frame)
+{
+    switch (frame.type) {
+    case TouchFrame::Down: {
+        if (m_isCancelled)
+            return Ignore;
+
+        int current_finger_count = frame.fingerCount;
+        int current_slot = frame.slot;
+
+        // a finger is pressed again after release.
+        if (m_isReleased || current_finger_count > N || current_slot >= N) {
+            m_isCancelled = true;
+            gestureCancelled();
+            return Cancelled;
+        }
+
+        if (current_finger_count == N) {
+            m_isStarted = true;
+            m_startTime = frame.time;
+            for (int i = 0; i < N; i++) {
+                m_startX[i] = frame.x[i];
+                m_startY[i] = frame.y[i];
+            }
+            gestureBegin();
+            return Maybe;
+        }
+        break;
+    }
+    case TouchFrame::Up: {
+        int current_finger_count = frame.fingerCount;
+
+        if (!m_isCancelled && m_isStarted && !m_isReleased) {
+            // the first finger released, take the velocity of all fingers.
+            m_isReleased = true;
+
+            float vx = 0;
+            float vy = 0;
+            for (int i = 0; i < N; i++) {
+                vx += frame.vx[i];
+                vy += frame.vy[i];
+            }
+            vx /= N;
+            vy /= N;
+
+            float startX, startY, x, y;
+            TouchPointKernels::centroid<N>(m_startX, m_startY, startX, startY);
+            TouchPointKernels::centroid(frame.x, frame.y, N, x, y);
+            float distance = qAbs(x - startX) + qAbs(y - startY);
+
+            if (frame.time - m_startTime <= FLICK_MAX_DURATION && distance >= FLICK_MIN_DISTANCE
+                    && qAbs(vx) + qAbs(vy) >= FLICK_MIN_VELOCITY) {
+                if (qAbs(vx) > qAbs(vy)) {
+                    m_direction = vx > 0? Right: Left;
+                } else {
+                    m_direction = vy > 0? Down: Up;
+                }
+            }
+        }
+
+        if (current_finger_count <= 0) {
+            if (!m_isCancelled && m_direction != None) {
+                gestureFinished();
+                return Finished;
+            } else {
+                reset();
+                return Ignore;
+            }
+        }
+        break;
+    }
+    case TouchFrame::Cancel: {
+        m_isCancelled = true;
+        gestureCancelled();
+        return Cancelled;
+    }
+    default:
+        break;
+    }
+
+    return Ignore;
+}
+
+template<int N>
+void TouchScreenMultiFingerFlickGesture<N>::reset()
+{
+    m_isCancelled = false;
+    m_isStarted = false;
+    m_isReleased = false;
+    m_direction = None;
+    m_startTime = 0;
+
+    for (int i = 0; i < N; i++) {
+        m_startX[i] = m_startY[i] = 0;
+    }
+}
+
+template<int N>
+void TouchScreenMultiFingerFlickGesture<N>::cancel()
+{
+    if (m_isCancelled)
+        return;
+
+    m_isCancelled = true;
+    gestureCancelled();
+}
+
+template class TouchScreenMultiFingerFlickGesture<2>;
+template class TouchScreenMultiFingerFlickGesture<3>;
+template class TouchScreenMultiFingerFlickGesture<4>;
+template class TouchScreenMultiFingerFlickGesture<5>;
@@ -0,0 +1,82 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef TOUCHSCREENMULTIFINGERFLICKGESTURE_H
+#define TOUCHSCREENMULTIFINGERFLICKGESTURE_H
+
+#include "touch-screen-gesture-interface.h"
+
+/*!
+ * \brief The TouchScreenMultiFingerFlickGesture class
+ * recognizes a short and fast swipe of N fingers by the velocity when the
+ * fingers are released, rather than the distance they moved. It should be
+ * registered after the swipe gestures, so a swipe is not taken as a flick
+ * too. It is instantiated for 2 to 5 fingers in the source file.
+ */
+template<int N>
+class TouchScreenMultiFingerFlickGesture : public TouchScreenGestureInterface
+{
+    static_assert(N >= 2 && N <= 10, "2 to 10 fingers are supported");
+
+public:
+    explicit TouchScreenMultiFingerFlickGesture(TouchScreenGestureManager *manager = nullptr);
+
+    int finger() override {return N;}
+
+    GestureType type() override {return Flick;}
+
+    State handleInputEvent(const TouchFrame &frame) override;
+
+    // the velocity of frame events is not used, only the release one.
+    bool acceptsEvent(TouchFrame::EventType type, int fingerCount) override {
+        return type != TouchFrame::Frame && TouchScreenGestureInterface::acceptsEvent(type, fingerCount);
+    }
+
+    void reset() override;
+
+    Direction totalDirection() override {return m_direction;}
+
+    Direction lastDirection() override {return m_direction;}
+
+    void cancel() override;
+
+    bool isCancelled() override {return m_isCancelled;}
+
+private:
+    bool m_isCancelled = false;
+    bool m_isStarted = false;
+    bool m_isReleased = false;
+
+    Direction m_direction = None;
+
+    quint64 m_startTime = 0;
+
+    float m_startX[N] = {};
+    float m_startY[N] = {};
+};
+
+typedef TouchScreenMultiFingerFlickGesture<2> TouchScreenTwoFingerFlickGesture;
+typedef TouchScreenMultiFingerFlickGesture<3> TouchScreenThreeFingerFlickGesture;
+typedef TouchScreenMultiFingerFlickGesture<4> TouchScreenFourFingerFlickGesture;
+typedef TouchScreenMultiFingerFlickGesture<5> TouchScreenFiveFingerFlickGesture;
+
+#endif // TOUCHSCREENMULTIFINGERFLICKGESTURE_H
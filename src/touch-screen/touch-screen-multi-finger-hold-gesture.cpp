@@ -0,0 +1,142 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "touch-screen-multi-finger-hold-gesture.h"
+
+// from all fingers pressed to the hold recognized, in msec.
+#define HOLD_TIMEOUT 500
+// a finger moves farther than it is not held, in mm.
+#define HOLD_MAX_DISTANCE 5
+
+template<int N>
+TouchScreenMultiFingerHoldGesture<N>::TouchScreenMultiFingerHoldGesture(TouchScreenGestureManager *manager) : TouchScreenGestureInterface(manager),
+    m_holdTimer([=](){onHoldTimeout();})
+{
+
+}
+
+template<int N>
+TouchScreenGestureInterface::State TouchScreenMultiFingerHoldGesture<N>::handleInputEvent(const TouchFrame &frame)
+{
+    switch (frame.type) {
+    case TouchFrame::Down: {
+        if (m_isCancelled)
+            return Ignore;
+
+        int current_finger_count = frame.fingerCount;
+        int current_slot = frame.slot;
+
+        // more fingers, or a finger pressed again after the hold started.
+        if (m_isStarted || current_finger_count > N || current_slot >= N) {
+            cancel();
+            return Cancelled;
+        }
+
+        m_startX[current_slot] = frame.x[current_slot];
+        m_startY[current_slot] = frame.y[current_slot];
+
+        if (current_finger_count == N) {
+            m_isStarted = true;
+            m_holdTimer.start(HOLD_TIMEOUT * 1000);
+            gestureBegin();
+            return Maybe;
+        }
+        break;
+    }
+    case TouchFrame::Motion: {
+        if (m_isCancelled)
+            return Ignore;
+
+        int current_slot = frame.slot;
+        if (current_slot >= N)
+            return Ignore;
+
+        float delta = qAbs(frame.x[current_slot] - m_startX[current_slot]) + qAbs(frame.y[current_slot] - m_startY[current_slot]);
+        if (delta > HOLD_MAX_DISTANCE) {
+            cancel();
+            return Cancelled;
+        }
+        break;
+    }
+    case TouchFrame::Up: {
+        // released before the deadline.
+        m_holdTimer.stop();
+        if (frame.fingerCount <= 0) {
+            reset();
+        } else if (!m_isCancelled && m_isStarted) {
+            cancel();
+            return Cancelled;
+        }
+        break;
+    }
+    case TouchFrame::Cancel: {
+        cancel();
+        return Cancelled;
+    }
+    default:
+        break;
+    }
+
+    return Ignore;
+}
+
+template<int N>
+void TouchScreenMultiFingerHoldGesture<N>::reset()
+{
+    m_holdTimer.stop();
+    m_isCancelled = false;
+    m_isStarted = false;
+
+    for (int i = 0; i < N; i++) {
+        m_startX[i] = m_startY[i] = 0;
+    }
+}
+
+template<int N>
+void TouchScreenMultiFingerHoldGesture<N>::cancel()
+{
+    m_holdTimer.stop();
+    if (m_isCancelled)
+        return;
+
+    m_isCancelled = true;
+    gestureCancelled();
+}
+
+template<int N>
+void TouchScreenMultiFingerHoldGesture<N>::onHoldTimeout()
+{
+    if (m_isCancelled || !m_isStarted)
+        return;
+
+    // the fingers are still on the screen. If the hold is bound, the manager
+    // swallows the rest of the sequence, otherwise the hold stays cancelled
+    // and ignores it until the fingers are released.
+    m_isCancelled = true;
+    gestureFinished();
+}
+
+template class TouchScreenMultiFingerHoldGesture<1>;
+template class TouchScreenMultiFingerHoldGesture<2>;
+template class TouchScreenMultiFingerHoldGesture<3>;
+template class TouchScreenMultiFingerHoldGesture<4>;
+template class TouchScreenMultiFingerHoldGesture<5>;
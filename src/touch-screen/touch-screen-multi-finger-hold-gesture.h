@@ -0,0 +1,78 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef TOUCHSCREENMULTIFINGERHOLDGESTURE_H
+#define TOUCHSCREENMULTIFINGERHOLDGESTURE_H
+
+#include "touch-screen-gesture-interface.h"
+#include "deadline-timer.h"
+
+/*!
+ * \brief The TouchScreenMultiFingerHoldGesture class
+ * recognizes N fingers pressed without moving. It is finished by a
+ * deadline timer as soon as the fingers are held long enough, not by the
+ * release. It is instantiated for 1 to 5 fingers in the source file.
+ */
+template<int N>
+class TouchScreenMultiFingerHoldGesture : public TouchScreenGestureInterface
+{
+    static_assert(N >= 1 && N <= 10, "1 to 10 fingers are supported");
+
+public:
+    explicit TouchScreenMultiFingerHoldGesture(TouchScreenGestureManager *manager = nullptr);
+
+    int finger() override {return N;}
+
+    GestureType type() override {return Hold;}
+
+    State handleInputEvent(const TouchFrame &frame) override;
+
+    // the positions are checked by motion events.
+    bool acceptsEvent(TouchFrame::EventType type, int fingerCount) override {
+        return type != TouchFrame::Frame && TouchScreenGestureInterface::acceptsEvent(type, fingerCount);
+    }
+
+    void reset() override;
+
+    void cancel() override;
+
+    bool isCancelled() override {return m_isCancelled;}
+
+private:
+    void onHoldTimeout();
+
+    bool m_isCancelled = false;
+    bool m_isStarted = false;
+
+    float m_startX[N] = {};
+    float m_startY[N] = {};
+
+    DeadlineTimer m_holdTimer;
+};
+
+typedef TouchScreenMultiFingerHoldGesture<1> TouchScreenOneFingerHoldGesture;
+typedef TouchScreenMultiFingerHoldGesture<2> TouchScreenTwoFingerHoldGesture;
+typedef TouchScreenMultiFingerHoldGesture<3> TouchScreenThreeFingerHoldGesture;
+typedef TouchScreenMultiFingerHoldGesture<4> TouchScreenFourFingerHoldGesture;
+typedef TouchScreenMultiFingerHoldGesture<5> TouchScreenFiveFingerHoldGesture;
+
+#endif // TOUCHSCREENMULTIFINGERHOLDGESTURE_H
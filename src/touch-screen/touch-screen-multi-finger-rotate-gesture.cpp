@@ -0,0 +1,190 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "touch-screen-multi-finger-rotate-gesture.h"
+
+#include "touch-point-kernels.h"
+
+#include <QtMath>
+
+// the angle in degrees, which a rotation is updated or finished by.
+#define ROTATE_UPDATE_THRESHOLD 15
+#define ROTATE_TOTAL_THRESHOLD 20
+
+template<int N>
+TouchScreenMultiFingerRotateGesture<N>::TouchScreenMultiFingerRotateGesture(TouchScreenGestureManager *manager) : TouchScreenGestureInterface(manager)
+{
+
+}
+
+template<int N>
+TouchScreenGestureInterface::State TouchScreenMultiFingerRotateGesture<N>::handleInputEvent(const TouchFrame &frame)
+{
+    switch (frame.type) {
+    case TouchFrame::Down: {
+        if (m_isCancelled)
+            return Ignore;
+
+        int current_finger_count = frame.fingerCount;
+        int current_slot = frame.slot;
+
+        if (current_finger_count <= N && current_slot < N) {
+            m_currentX[current_slot] = frame.x[current_slot];
+            m_currentY[current_slot] = frame.y[current_slot];
+        }
+
+        if (current_finger_count == N) {
+            // start the gesture
+            m_isStarted = true;
+            m_lastAngle = 0;
+            m_totalAngle = 0;
+            for (int i = 0; i < N; i++) {
+                m_lastX[i] = m_currentX[i];
+                m_lastY[i] = m_currentY[i];
+            }
+            gestureBegin();
+            return Maybe;
+        }
+
+        if (current_finger_count > N) {
+            m_isCancelled = true;
+            gestureCancelled();
+            return Cancelled;
+        }
+        break;
+    }
+    case TouchFrame::Motion: {
+        if (m_isCancelled)
+            return Ignore;
+
+        int current_slot = frame.slot;
+        if (current_slot >= N)
+            return Ignore;
+
+        m_currentX[current_slot] = frame.x[current_slot];
+        m_currentY[current_slot] = frame.y[current_slot];
+        break;
+    }
+    case TouchFrame::Up: {
+        int current_finger_count = frame.fingerCount;
+
+        if (current_finger_count <= 0) {
+            if (!m_isCancelled && m_isStarted && m_lastDirection != None) {
+                gestureFinished();
+                return Finished;
+            } else {
+                reset();
+                return Ignore;
+            }
+        }
+
+        break;
+    }
+    case TouchFrame::Frame: {
+        if (m_isCancelled || !m_isStarted)
+            return Ignore;
+
+        if (frame.fingerCount != N)
+            return Ignore;
+
+        // accumulate the rotation since last frame.
+        double delta = qRadiansToDegrees(TouchPointKernels::rotation<N>(m_lastX, m_lastY, m_currentX, m_currentY));
+        for (int i = 0; i < N; i++) {
+            m_lastX[i] = m_currentX[i];
+            m_lastY[i] = m_currentY[i];
+        }
+
+        m_lastAngle += delta;
+        m_totalAngle += delta;
+        if (qAbs(m_lastAngle) < ROTATE_UPDATE_THRESHOLD) {
+            return Ignore;
+        }
+
+        m_lastDirection = m_lastAngle > 0? RotateClockwise: RotateCounterClockwise;
+        m_lastDelta = qAbs(m_lastAngle);
+        m_lastAngle = 0;
+
+        gestureUpdate();
+
+        return Update;
+    }
+    case TouchFrame::Cancel: {
+        m_isCancelled = true;
+        gestureCancelled();
+        return Cancelled;
+    }
+    default:
+        break;
+    }
+
+    return Ignore;
+}
+
+template<int N>
+void TouchScreenMultiFingerRotateGesture<N>::reset()
+{
+    m_isCancelled = false;
+    m_isStarted = false;
+    m_lastDirection = None;
+
+    m_lastAngle = 0;
+    m_totalAngle = 0;
+    m_lastDelta = 0;
+
+    for (int i = 0; i < N; i++) {
+        m_lastX[i] = m_lastY[i] = 0;
+        m_currentX[i] = m_currentY[i] = 0;
+    }
+}
+
+template<int N>
+TouchScreenGestureInterface::Direction TouchScreenMultiFingerRotateGesture<N>::totalDirection()
+{
+    if (m_totalAngle > ROTATE_TOTAL_THRESHOLD) {
+        return RotateClockwise;
+    } else if (m_totalAngle < -ROTATE_TOTAL_THRESHOLD) {
+        return RotateCounterClockwise;
+    }
+
+    return None;
+}
+
+template<int N>
+TouchScreenGestureInterface::Direction TouchScreenMultiFingerRotateGesture<N>::lastDirection()
+{
+    return m_lastDirection;
+}
+
+template<int N>
+void TouchScreenMultiFingerRotateGesture<N>::cancel()
+{
+    if (m_isCancelled)
+        return;
+
+    m_isCancelled = true;
+    gestureCancelled();
+}
+
+template class TouchScreenMultiFingerRotateGesture<2>;
+template class TouchScreenMultiFingerRotateGesture<3>;
+template class TouchScreenMultiFingerRotateGesture<4>;
+template class TouchScreenMultiFingerRotateGesture<5>;
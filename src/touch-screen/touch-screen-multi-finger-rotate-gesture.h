@@ -0,0 +1,83 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef TOUCHSCREENMULTIFINGERROTATEGESTURE_H
+#define TOUCHSCREENMULTIFINGERROTATEGESTURE_H
+
+#include "touch-screen-gesture-interface.h"
+
+/*!
+ * \brief The TouchScreenMultiFingerRotateGesture class
+ * recognizes the rotation of N fingers around their centroid. The angle is
+ * accumulated from the rotation between every two frames, so only the
+ * positions of the last frame are kept. It is instantiated for 2 to 5
+ * fingers in the source file.
+ */
+template<int N>
+class TouchScreenMultiFingerRotateGesture : public TouchScreenGestureInterface
+{
+    static_assert(N >= 2 && N <= 10, "2 to 10 fingers are supported");
+
+public:
+    explicit TouchScreenMultiFingerRotateGesture(TouchScreenGestureManager *manager = nullptr);
+
+    int finger() override {return N;}
+
+    GestureType type() override {return Rotate;}
+
+    State handleInputEvent(const TouchFrame &frame) override;
+
+    void reset() override;
+
+    Direction totalDirection() override;
+
+    Direction lastDirection() override;
+
+    double lastDelta() override {return m_lastDelta;}
+
+    void cancel() override;
+
+    bool isCancelled() override {return m_isCancelled;}
+
+private:
+    bool m_isCancelled = false;
+    bool m_isStarted = false;
+
+    Direction m_lastDirection = None;
+    double m_lastDelta = 0;
+
+    // in degrees, clockwise on the screen.
+    double m_lastAngle = 0;
+    double m_totalAngle = 0;
+
+    float m_lastX[N] = {};
+    float m_lastY[N] = {};
+    float m_currentX[N] = {};
+    float m_currentY[N] = {};
+};
+
+typedef TouchScreenMultiFingerRotateGesture<2> TouchScreenTwoFingerRotateGesture;
+typedef TouchScreenMultiFingerRotateGesture<3> TouchScreenThreeFingerRotateGesture;
+typedef TouchScreenMultiFingerRotateGesture<4> TouchScreenFourFingerRotateGesture;
+typedef TouchScreenMultiFingerRotateGesture<5> TouchScreenFiveFingerRotateGesture;
+
+#endif // TOUCHSCREENMULTIFINGERROTATEGESTURE_H
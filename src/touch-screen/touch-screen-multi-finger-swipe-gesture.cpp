@@ -0,0 +1,233 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "touch-screen-multi-finger-swipe-gesture.h"
+
+#include "touch-point-kernels.h"
+
+#include <QDebug>
+
+// the offset of center, which a swipe is recognized by, for each finger count.
+static const double swipe_thresholds[] = {0, 0, 20, 20, 25, 20, 25, 25, 25, 25, 25};
+// a swipe is unambiguous when its center moved this times of the threshold,
+// and this times more along the direction than across it.
+#define SWIPE_COMMIT_DISTANCE_RATIO 1.5
+#define SWIPE_COMMIT_AXIS_RATIO 2
+
+template<int N>
+TouchScreenMultiFingerSwipeGesture<N>::TouchScreenMultiFingerSwipeGesture(TouchScreenGestureManager *manager) : TouchScreenGestureInterface(manager)
+{
+    reset();
+}
+
+template<int N>
+TouchScreenGestureInterface::State TouchScreenMultiFingerSwipeGesture<N>::handleInputEvent(const TouchFrame &frame)
+{
+    switch (frame.type) {
+    case TouchFrame::Down: {
+        if (m_isCancelled)
+            return Ignore;
+
+        int current_finger_count = frame.fingerCount;
+        //qDebug()<<"current finger count:"<<current_finger_count;
+        int current_slot = frame.slot;
+
+        if (current_finger_count <= N && current_slot < N) {
+            m_startX[current_slot] = frame.x[current_slot];
+            m_startY[current_slot] = frame.y[current_slot];
+        }
+
+        if (current_finger_count == N) {
+            // start the gesture
+            m_isStarted = true;
+            for (int i = 0; i < N; i++) {
+                m_lastX[i] = m_currentX[i] = m_startX[i];
+                m_lastY[i] = m_currentY[i] = m_startY[i];
+            }
+            gestureBegin();
+            return Maybe;
+        }
+
+        if (current_finger_count > N) {
+            m_isCancelled = true;
+            gestureCancelled();
+            return Cancelled;
+        }
+        break;
+    }
+    case TouchFrame::Motion: {
+        if (m_isCancelled)
+            return Ignore;
+
+        // update position
+        int current_slot = frame.slot;
+        if (current_slot >= N)
+            return Ignore;
+
+        m_currentX[current_slot] = frame.x[current_slot];
+        m_currentY[current_slot] = frame.y[current_slot];
+
+        if (!m_isStarted) {
+            m_startX[current_slot] = m_currentX[current_slot];
+            m_startY[current_slot] = m_currentY[current_slot];
+        }
+        break;
+    }
+    case TouchFrame::Up: {
+        //m_isCancelled = true;
+        int current_finger_count = frame.fingerCount;
+
+        if (current_finger_count <= 0) {
+            if (!m_isCancelled && m_isStarted && m_lastDirection != None) {
+                gestureFinished();
+                //qDebug()<<"total direction:"<<totalDirection();
+                return Finished;
+            } else {
+                // we have post cancel event yet.
+                reset();
+                return Ignore;
+            }
+        }
+
+        break;
+    }
+    case TouchFrame::Frame: {
+        if (m_isCancelled || !m_isStarted)
+            return Ignore;
+
+        if (frame.fingerCount != N)
+            return Ignore;
+
+        // update gesture
+
+        // count offset
+        auto delta = center(m_currentX, m_currentY) - center(m_lastX, m_lastY);
+        auto offset = delta.manhattanLength();
+        if (offset < swipe_thresholds[N]) {
+            return isUnambiguous()? Pending: Ignore;
+        }
+
+        for (int i = 0; i < N; i++) {
+            m_lastX[i] = m_currentX[i];
+            m_lastY[i] = m_currentY[i];
+        }
+
+        m_lastDirection = direction(delta);
+        m_lastDelta = offset;
+
+        gestureUpdate();
+
+        return isUnambiguous()? Pending: Update;
+    }
+    case TouchFrame::Cancel: {
+        m_isCancelled = true;
+        gestureCancelled();
+        return Cancelled;
+    }
+    default:
+        break;
+    }
+
+    return Ignore;
+}
+
+template<int N>
+void TouchScreenMultiFingerSwipeGesture<N>::reset()
+{
+    m_isCancelled = false;
+    m_isStarted = false;
+    m_lastDirection = None;
+    m_lastDelta = 0;
+
+    for (int i = 0; i < N; i++) {
+        m_startX[i] = m_startY[i] = 0;
+        m_lastX[i] = m_lastY[i] = 0;
+        m_currentX[i] = m_currentY[i] = 0;
+    }
+}
+
+template<int N>
+TouchScreenGestureInterface::Direction TouchScreenMultiFingerSwipeGesture<N>::totalDirection()
+{
+    // count total offset
+    auto delta = center(m_currentX, m_currentY) - center(m_startX, m_startY);
+    auto offset = delta.manhattanLength();
+    if (offset < swipe_thresholds[N]) {
+        return None;
+    }
+
+    return direction(delta);
+}
+
+template<int N>
+TouchScreenGestureInterface::Direction TouchScreenMultiFingerSwipeGesture<N>::lastDirection()
+{
+    return m_lastDirection;
+}
+
+template<int N>
+void TouchScreenMultiFingerSwipeGesture<N>::cancel()
+{
+    m_isCancelled = true;
+    gestureCancelled();
+}
+
+template<int N>
+bool TouchScreenMultiFingerSwipeGesture<N>::isUnambiguous()
+{
+    if (m_lastDirection == None)
+        return false;
+
+    auto delta = center(m_currentX, m_currentY) - center(m_startX, m_startY);
+    double along = qMax(qAbs(delta.x()), qAbs(delta.y()));
+    double across = qMin(qAbs(delta.x()), qAbs(delta.y()));
+    return delta.manhattanLength() >= SWIPE_COMMIT_DISTANCE_RATIO * swipe_thresholds[N]
+            && along >= SWIPE_COMMIT_AXIS_RATIO * across;
+}
+
+template<int N>
+QPointF TouchScreenMultiFingerSwipeGesture<N>::center(const float (&x)[N], const float (&y)[N])
+{
+    float cx, cy;
+    TouchPointKernels::centroid<N>(x, y, cx, cy);
+    return QPointF(cx, cy);
+}
+
+template<int N>
+TouchScreenGestureInterface::Direction TouchScreenMultiFingerSwipeGesture<N>::direction(const QPointF &delta)
+{
+    if (qAbs(delta.x()) > qAbs(delta.y())) {
+        return delta.x() > 0? Right: Left;
+    } else {
+        return delta.y() > 0? Down: Up;
+    }
+}
+
+template class TouchScreenMultiFingerSwipeGesture<2>;
+template class TouchScreenMultiFingerSwipeGesture<3>;
+template class TouchScreenMultiFingerSwipeGesture<4>;
+template class TouchScreenMultiFingerSwipeGesture<5>;
+template class TouchScreenMultiFingerSwipeGesture<6>;
+template class TouchScreenMultiFingerSwipeGesture<7>;
+template class TouchScreenMultiFingerSwipeGesture<8>;
+template class TouchScreenMultiFingerSwipeGesture<9>;
+template class TouchScreenMultiFingerSwipeGesture<10>;
@@ -0,0 +1,87 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef TOUCHSCREENMULTIFINGERSWIPEGESTURE_H
+#define TOUCHSCREENMULTIFINGERSWIPEGESTURE_H
+
+#include "touch-screen-gesture-interface.h"
+
+#include <QPointF>
+
+/*!
+ * \brief The TouchScreenMultiFingerSwipeGesture class
+ * recognizes the swipe of N fingers by their centroid. It is instantiated
+ * for 2 to 10 fingers in the source file.
+ */
+template<int N>
+class TouchScreenMultiFingerSwipeGesture : public TouchScreenGestureInterface
+{
+    static_assert(N >= 2 && N <= 10, "2 to 10 fingers are supported");
+
+public:
+    explicit TouchScreenMultiFingerSwipeGesture(TouchScreenGestureManager *manager = nullptr);
+
+    int finger() override {return N;}
+
+    GestureType type() override {return Swipe;}
+
+    State handleInputEvent(const TouchFrame &frame) override;
+
+    void reset() override;
+
+    Direction totalDirection() override;
+
+    Direction lastDirection() override;
+
+    double lastDelta() override {return m_lastDelta;}
+
+    void cancel() override;
+
+    bool isCancelled() override {return m_isCancelled;}
+
+private:
+    // the total direction can't change any more, see Pending.
+    bool isUnambiguous();
+
+    static QPointF center(const float (&x)[N], const float (&y)[N]);
+    static Direction direction(const QPointF &delta);
+
+    bool m_isCancelled = false;
+    bool m_isStarted = false;
+
+    Direction m_lastDirection = None;
+    double m_lastDelta = 0;
+
+    // the positions are stored as arrays of x and y for TouchPointKernels.
+    float m_startX[N] = {};
+    float m_startY[N] = {};
+    float m_lastX[N] = {};
+    float m_lastY[N] = {};
+    float m_currentX[N] = {};
+    float m_currentY[N] = {};
+};
+
+typedef TouchScreenMultiFingerSwipeGesture<3> TouchScreenThreeFingerSwipeGesture;
+typedef TouchScreenMultiFingerSwipeGesture<4> TouchScreenFourFingerSwipeGesture;
+typedef TouchScreenMultiFingerSwipeGesture<5> TouchScreenFiveFingerSwipeGesture;
+
+#endif // TOUCHSCREENMULTIFINGERSWIPEGESTURE_H
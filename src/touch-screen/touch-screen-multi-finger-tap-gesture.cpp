@@ -0,0 +1,201 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "touch-screen-multi-finger-tap-gesture.h"
+
+#include "settings-manager.h"
+
+// the longest time fingers pressed for a tap, in msec.
+#define TAP_TIMEOUT 300
+// the farthest a finger moves in a tap, in mm.
+#define TAP_MAX_DISTANCE 10
+// the farthest a finger lands from the first one, in mm.
+#define TAP_MAX_SPREAD 50
+
+template<int N>
+TouchScreenMultiFingerTapGesture<N>::TouchScreenMultiFingerTapGesture(TouchScreenGestureManager *manager) : TouchScreenGestureInterface(manager),
+    m_timer([=](){onTimeout();})
+{
+
+}
+
+template<int N>
+TouchScreenGestureInterface::GestureType TouchScreenMultiFingerTapGesture<N>::type()
+{
+    switch (m_tapCount) {
+    case 2:
+        return DoubleTap;
+    case 3:
+        return TripleTap;
+    default:
+        return Tap;
+    }
+}
+
+template<int N>
+TouchScreenGestureInterface::State TouchScreenMultiFingerTapGesture<N>::handleInputEvent(const TouchFrame &frame)
+{
+    switch (frame.type) {
+    case TouchFrame::Down: {
+        if (m_isCancelled)
+            return Ignore;
+
+        int current_finger_count = frame.fingerCount;
+        int current_slot = frame.slot;
+
+        // the next tap is pressed in time.
+        if (current_finger_count == 1)
+            m_timer.stop();
+
+        if (m_isPressed || current_finger_count > N || current_slot >= N) {
+            cancel();
+            return Cancelled;
+        }
+
+        m_startX[current_slot] = frame.x[current_slot];
+        m_startY[current_slot] = frame.y[current_slot];
+
+        if (current_finger_count == N) {
+            for (int i = 1; i < N; i++) {
+                if (qAbs(m_startX[i] - m_startX[0]) + qAbs(m_startY[i] - m_startY[0]) > TAP_MAX_SPREAD) {
+                    cancel();
+                    return Cancelled;
+                }
+            }
+
+            m_isPressed = true;
+            m_startTime = frame.time;
+            // give up at the deadline, rather than at the next event.
+            m_timer.start(TAP_TIMEOUT * 1000);
+            if (m_tapCount == 0)
+                gestureBegin();
+            return Maybe;
+        }
+        break;
+    }
+    case TouchFrame::Motion: {
+        if (m_isCancelled)
+            return Ignore;
+
+        int current_slot = frame.slot;
+        if (current_slot >= N)
+            return Ignore;
+
+        float delta = qAbs(frame.x[current_slot] - m_startX[current_slot]) + qAbs(frame.y[current_slot] - m_startY[current_slot]);
+        if (delta > TAP_MAX_DISTANCE) {
+            cancel();
+            return Cancelled;
+        }
+        break;
+    }
+    case TouchFrame::Up: {
+        if (frame.fingerCount > 0)
+            break;
+
+        m_timer.stop();
+        if (m_isCancelled || !m_isPressed || frame.time - m_startTime >= TAP_TIMEOUT * 1000) {
+            reset();
+            return Ignore;
+        }
+
+        m_isPressed = false;
+        m_tapCount++;
+
+        if (m_settingsGeneration != SettingsManager::getManager()->generation())
+            loadSettings();
+
+        // wait for the next tap only if more taps are bound.
+        if (m_tapCount >= m_maxTapCount) {
+            gestureFinished();
+            return Finished;
+        }
+
+        m_timer.start(m_tapInterval * 1000);
+        return Maybe;
+    }
+    case TouchFrame::Cancel: {
+        cancel();
+        return Cancelled;
+    }
+    default:
+        break;
+    }
+
+    return Ignore;
+}
+
+template<int N>
+void TouchScreenMultiFingerTapGesture<N>::reset()
+{
+    m_timer.stop();
+    m_startTime = 0;
+    m_tapCount = 0;
+    m_isPressed = false;
+    m_isCancelled = false;
+
+    for (int i = 0; i < N; i++) {
+        m_startX[i] = m_startY[i] = 0;
+    }
+}
+
+template<int N>
+void TouchScreenMultiFingerTapGesture<N>::cancel()
+{
+    m_timer.stop();
+    if (m_isCancelled)
+        return;
+
+    m_isCancelled = true;
+    gestureCancelled();
+}
+
+template<int N>
+void TouchScreenMultiFingerTapGesture<N>::loadSettings()
+{
+    auto settingsManager = SettingsManager::getManager();
+    m_settingsGeneration = settingsManager->generation();
+    m_maxTapCount = settingsManager->getMaxTapCount(N);
+    m_tapInterval = settingsManager->tapInterval();
+}
+
+template<int N>
+void TouchScreenMultiFingerTapGesture<N>::onTimeout()
+{
+    if (m_isCancelled)
+        return;
+
+    if (m_isPressed) {
+        // pressed too long for a tap.
+        cancel();
+        return;
+    }
+
+    // no more tap comes in the interval.
+    if (m_tapCount > 0)
+        gestureFinished();
+}
+
+template class TouchScreenMultiFingerTapGesture<1>;
+template class TouchScreenMultiFingerTapGesture<2>;
+template class TouchScreenMultiFingerTapGesture<3>;
+template class TouchScreenMultiFingerTapGesture<4>;
+template class TouchScreenMultiFingerTapGesture<5>;
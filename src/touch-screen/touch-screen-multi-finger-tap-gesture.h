@@ -0,0 +1,90 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef TOUCHSCREENMULTIFINGERTAPGESTURE_H
+#define TOUCHSCREENMULTIFINGERTAPGESTURE_H
+
+#include "touch-screen-gesture-interface.h"
+#include "deadline-timer.h"
+
+/*!
+ * \brief The TouchScreenMultiFingerTapGesture class
+ * counts the consecutive taps of N fingers. After a tap is released, the
+ * next one must be pressed within the tap interval, or the sequence is
+ * committed at the deadline. The type() is Tap, DoubleTap or TripleTap by
+ * the taps counted, and the sequence is committed at once if no more taps
+ * are bound. It is instantiated for 1 to 5 fingers in the source file.
+ */
+template<int N>
+class TouchScreenMultiFingerTapGesture : public TouchScreenGestureInterface
+{
+    static_assert(N >= 1 && N <= 10, "1 to 10 fingers are supported");
+
+public:
+    explicit TouchScreenMultiFingerTapGesture(TouchScreenGestureManager *manager = nullptr);
+
+    int finger() override {return N;}
+
+    GestureType type() override;
+
+    State handleInputEvent(const TouchFrame &frame) override;
+
+    // no frame event is used.
+    bool acceptsEvent(TouchFrame::EventType type, int fingerCount) override {
+        return type != TouchFrame::Frame && TouchScreenGestureInterface::acceptsEvent(type, fingerCount);
+    }
+
+    void reset() override;
+
+    void cancel() override;
+
+    bool isCancelled() override {return m_isCancelled;}
+
+private:
+    void onTimeout();
+    void loadSettings();
+
+    quint64 m_startTime = 0;
+
+    int m_tapCount = 0;
+    bool m_isPressed = false; // all the N fingers of current tap are down
+    bool m_isCancelled = false;
+
+    float m_startX[N] = {};
+    float m_startY[N] = {};
+
+    // the deadline of the pressed tap, then the interval to the next tap.
+    DeadlineTimer m_timer;
+
+    // read from settings once for each settings generation.
+    int m_settingsGeneration = -1;
+    int m_maxTapCount = 1;
+    int m_tapInterval = 250; // in msec
+};
+
+typedef TouchScreenMultiFingerTapGesture<1> TouchScreenOneFingerTapGesture;
+typedef TouchScreenMultiFingerTapGesture<2> TouchScreenTwoFingerTapGesture;
+typedef TouchScreenMultiFingerTapGesture<3> TouchScreenThreeFingerTapGesture;
+typedef TouchScreenMultiFingerTapGesture<4> TouchScreenFourFingerTapGesture;
+typedef TouchScreenMultiFingerTapGesture<5> TouchScreenFiveFingerTapGesture;
+
+#endif // TOUCHSCREENMULTIFINGERTAPGESTURE_H
@@ -0,0 +1,214 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "touch-screen-multi-finger-zoom-gesture.h"
+
+#include "touch-point-kernels.h"
+
+// the change of spread, which a zoom is updated or finished by, for each finger count.
+static const double zoom_update_thresholds[] = {0, 0, 20, 15, 20, 25, 25, 25, 25, 25, 25};
+static const double zoom_total_thresholds[] = {0, 0, 15, 15, 20, 25, 25, 25, 25, 25, 25};
+
+template<int N>
+TouchScreenMultiFingerZoomGesture<N>::TouchScreenMultiFingerZoomGesture(TouchScreenGestureManager *manager) : TouchScreenGestureInterface(manager)
+{
+
+}
+
+template<int N>
+TouchScreenGestureInterface::State TouchScreenMultiFingerZoomGesture<N>::handleInputEvent(const TouchFrame &frame)
+{
+    switch (frame.type) {
+    case TouchFrame::Down: {
+        if (m_isCancelled)
+            return Ignore;
+
+        int current_finger_count = frame.fingerCount;
+        //qDebug()<<"current finger count:"<<current_finger_count;
+        int current_slot = frame.slot;
+
+        if (current_finger_count <= N && current_slot < N) {
+            m_startX[current_slot] = frame.x[current_slot];
+            m_startY[current_slot] = frame.y[current_slot];
+        }
+
+        if (current_finger_count == N) {
+            // start the gesture
+            m_isStarted = true;
+            for (int i = 0; i < N; i++) {
+                m_lastX[i] = m_currentX[i] = m_startX[i];
+                m_lastY[i] = m_currentY[i] = m_startY[i];
+            }
+            gestureBegin();
+            return Maybe;
+        }
+
+        if (current_finger_count > N) {
+            m_isCancelled = true;
+            gestureCancelled();
+            return Cancelled;
+        }
+        break;
+    }
+    case TouchFrame::Motion: {
+        if (m_isCancelled)
+            return Ignore;
+
+        // update position
+        int current_slot = frame.slot;
+        if (current_slot >= N)
+            return Ignore;
+
+        m_currentX[current_slot] = frame.x[current_slot];
+        m_currentY[current_slot] = frame.y[current_slot];
+
+        if (!m_isStarted) {
+            m_startX[current_slot] = m_currentX[current_slot];
+            m_startY[current_slot] = m_currentY[current_slot];
+        }
+        break;
+    }
+    case TouchFrame::Up: {
+        //m_isCancelled = true;
+        int current_finger_count = frame.fingerCount;
+
+        if (current_finger_count <= 0) {
+            if (!m_isCancelled && m_isStarted && m_lastDirection != None) {
+                gestureFinished();
+                //qDebug()<<"total direction:"<<totalDirection();
+                return Finished;
+            } else {
+                // we have post cancel event yet.
+                reset();
+                return Ignore;
+            }
+        }
+
+        break;
+    }
+    case TouchFrame::Frame: {
+        if (m_isCancelled || !m_isStarted)
+            return Ignore;
+
+        if (frame.fingerCount != N)
+            return Ignore;
+
+        // update gesture
+
+        // count offset
+        auto delta = spread(m_currentX, m_currentY) - spread(m_lastX, m_lastY);
+        if (qAbs(delta) < zoom_update_thresholds[N]) {
+            return Ignore;
+        }
+
+        for (int i = 0; i < N; i++) {
+            m_lastX[i] = m_currentX[i];
+            m_lastY[i] = m_currentY[i];
+        }
+
+        m_lastDelta = qAbs(delta);
+        if (delta > 0) {
+            m_lastDirection = ZoomIn;
+        } else {
+            m_lastDirection = ZoomOut;
+        }
+
+        gestureUpdate();
+
+        return Update;
+    }
+    case TouchFrame::Cancel: {
+        m_isCancelled = true;
+        gestureCancelled();
+        return Cancelled;
+    }
+    default:
+        break;
+    }
+
+    return Ignore;
+}
+
+template<int N>
+void TouchScreenMultiFingerZoomGesture<N>::reset()
+{
+    m_isCancelled = false;
+    m_isStarted = false;
+    m_lastDirection = None;
+    m_lastDelta = 0;
+
+    for (int i = 0; i < N; i++) {
+        m_startX[i] = m_startY[i] = 0;
+        m_lastX[i] = m_lastY[i] = 0;
+        m_currentX[i] = m_currentY[i] = 0;
+    }
+}
+
+template<int N>
+TouchScreenGestureInterface::Direction TouchScreenMultiFingerZoomGesture<N>::totalDirection()
+{
+    // count offset
+    auto delta = spread(m_currentX, m_currentY) - spread(m_startX, m_startY);
+
+    if (delta > zoom_total_thresholds[N]) {
+        return ZoomIn;
+    } else if (delta < -zoom_total_thresholds[N]) {
+        return ZoomOut;
+    }
+
+    return None;
+}
+
+template<int N>
+TouchScreenGestureInterface::Direction TouchScreenMultiFingerZoomGesture<N>::lastDirection()
+{
+    return m_lastDirection;
+}
+
+template<int N>
+void TouchScreenMultiFingerZoomGesture<N>::cancel()
+{
+    // cancelled by an updated gesture whose conflicts contain zoom, only a
+    // rotation by default, see default_conflicts and
+    // SettingsManager::getConflicts() for the configured ones.
+    if (m_isCancelled)
+        return;
+
+    m_isCancelled = true;
+    gestureCancelled();
+}
+
+template<int N>
+double TouchScreenMultiFingerZoomGesture<N>::spread(const float (&x)[N], const float (&y)[N])
+{
+    return TouchPointKernels::spread<N>(x, y);
+}
+
+template class TouchScreenMultiFingerZoomGesture<2>;
+template class TouchScreenMultiFingerZoomGesture<3>;
+template class TouchScreenMultiFingerZoomGesture<4>;
+template class TouchScreenMultiFingerZoomGesture<5>;
+template class TouchScreenMultiFingerZoomGesture<6>;
+template class TouchScreenMultiFingerZoomGesture<7>;
+template class TouchScreenMultiFingerZoomGesture<8>;
+template class TouchScreenMultiFingerZoomGesture<9>;
+template class TouchScreenMultiFingerZoomGesture<10>;
@@ -25,17 +25,16 @@
 
 #include <QDebug>
 
-TouchScreenOneFingerEdgeGesture::TouchScreenOneFingerEdgeGesture(QObject *parent) : TouchScreenGestureInterface(parent)
+TouchScreenOneFingerEdgeGesture::TouchScreenOneFingerEdgeGesture(TouchScreenGestureManager *manager) : TouchScreenGestureInterface(manager)
 {
 
 }
 
-TouchScreenGestureInterface::State TouchScreenOneFingerEdgeGesture::handleInputEvent(libinput_event *event)
+TouchScreenGestureInterface::State TouchScreenOneFingerEdgeGesture::handleInputEvent(const TouchFrame &frame)
 {
-    switch (libinput_event_get_type(event)) {
-    case LIBINPUT_EVENT_TOUCH_DOWN: {
-        m_fingerCount++;
-        if (m_fingerCount > 1) {
+    switch (frame.type) {
+    case TouchFrame::Down: {
+        if (frame.fingerCount > 1) {
             cancel();
             return Cancelled;
         }
@@ -43,9 +42,9 @@ TouchScreenGestureInterface::State TouchScreenOneFingerEdgeGesture::handleInputE
         if (isCancelled())
             return Ignore;
 
-        auto touch_event = libinput_event_get_touch_event(event);
-        double nx = libinput_event_touch_get_x_transformed(touch_event, 100);
-        double ny = libinput_event_touch_get_y_transformed(touch_event, 100);
+        // in percent of the screen
+        double nx = frame.nx[frame.slot] * 100;
+        double ny = frame.ny[frame.slot] * 100;
 
         if (nx < 1) {
             m_direction = Left;
@@ -64,10 +63,7 @@ TouchScreenGestureInterface::State TouchScreenOneFingerEdgeGesture::handleInputE
             return Ignore;
         }
 
-        double mmx = libinput_event_touch_get_x(touch_event);
-        double mmy = libinput_event_touch_get_y(touch_event);
-
-        m_startPoint = QPointF(mmx, mmy);
+        m_startPoint = frame.position(frame.slot);
         m_lastPoint = m_startPoint;
         m_currentPoint = m_startPoint;
 
@@ -76,15 +72,14 @@ TouchScreenGestureInterface::State TouchScreenOneFingerEdgeGesture::handleInputE
         }
         break;
     }
-    case LIBINPUT_EVENT_TOUCH_MOTION: {
+    case TouchFrame::Motion: {
         if (m_direction == None) {
             return Ignore;
         }
 
         if (!m_isCancelled) {
-            auto touch_event = libinput_event_get_touch_event(event);
-            double nx = libinput_event_touch_get_x_transformed(touch_event, 100);
-            double ny = libinput_event_touch_get_y_transformed(touch_event, 100);
+            double nx = frame.nx[frame.slot] * 100;
+            double ny = frame.ny[frame.slot] * 100;
 
             m_currentPoint = QPointF(nx, ny);
             auto delta = (m_lastPoint - m_currentPoint).manhattanLength();
@@ -95,7 +90,7 @@ TouchScreenGestureInterface::State TouchScreenOneFingerEdgeGesture::handleInputE
                     qDebug()<<m_currentPoint;
                     if (offset.x() > 0) {
                         m_lastPoint = m_currentPoint;
-                        gestureUpdate(getGestureIndex());
+                        gestureUpdate();
                         qDebug()<<m_lastPoint;
                         return Update;
                     } else if (offset.x() < -10) {
@@ -107,7 +102,7 @@ TouchScreenGestureInterface::State TouchScreenOneFingerEdgeGesture::handleInputE
                 case Right : {
                     if (offset.x() < 0) {
                         m_lastPoint = m_currentPoint;
-                        gestureUpdate(getGestureIndex());
+                        gestureUpdate();
                         return Update;
                     } else if (offset.x() > 10) {
                         cancel();
@@ -118,7 +113,7 @@ TouchScreenGestureInterface::State TouchScreenOneFingerEdgeGesture::handleInputE
                 case Up: {
                     if (offset.y() > 0) {
                         m_lastPoint = m_currentPoint;
-                        gestureUpdate(getGestureIndex());
+                        gestureUpdate();
                         return Update;
                     } else if (offset.y() < -10) {
                         cancel();
@@ -129,7 +124,7 @@ TouchScreenGestureInterface::State TouchScreenOneFingerEdgeGesture::handleInputE
                 case Down: {
                     if (offset.y() < 0) {
                         m_lastPoint = m_currentPoint;
-                        gestureUpdate(getGestureIndex());
+                        gestureUpdate();
                         return Update;
                     } else if (offset.y() > 10) {
                         cancel();
@@ -146,9 +141,8 @@ TouchScreenGestureInterface::State TouchScreenOneFingerEdgeGesture::handleInputE
         }
         break;
     }
-    case LIBINPUT_EVENT_TOUCH_UP: {
-        m_fingerCount--;
-        if (m_fingerCount == 0) {
+    case TouchFrame::Up: {
+        if (frame.fingerCount == 0) {
             if (!m_isCancelled) {
                 if (m_direction == None) {
                     return Ignore;
@@ -159,7 +153,7 @@ TouchScreenGestureInterface::State TouchScreenOneFingerEdgeGesture::handleInputE
                         return Ignore;
                     }
                 }
-                gestureFinished(getGestureIndex());
+                gestureFinished();
                 qDebug()<<"longestDistance"<<longestDistance();
                 return Finished;
             } else {
@@ -168,7 +162,7 @@ TouchScreenGestureInterface::State TouchScreenOneFingerEdgeGesture::handleInputE
         }
         break;
     }
-    case LIBINPUT_EVENT_TOUCH_CANCEL: {
+    case TouchFrame::Cancel: {
         cancel();
         return Cancelled;
     }
@@ -196,7 +190,6 @@ TouchScreenGestureInterface::Direction TouchScreenOneFingerEdgeGesture::lastDire
 void TouchScreenOneFingerEdgeGesture::reset()
 {
     m_isCancelled = false;
-    m_fingerCount = 0;
     m_direction = None;
     m_startPoint = QPointF();
     m_lastPoint = QPointF();
@@ -215,7 +208,7 @@ void TouchScreenOneFingerEdgeGesture::cancel()
     m_startPoint = QPointF();
     m_lastPoint = QPointF();
     m_currentPoint = QPointF();
-    gestureCancelled(getGestureIndex());
+    gestureCancelled();
 }
 
 int TouchScreenOneFingerEdgeGesture::longestDistance()
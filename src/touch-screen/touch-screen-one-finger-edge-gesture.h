@@ -31,13 +31,18 @@
 class TouchScreenOneFingerEdgeGesture : public TouchScreenGestureInterface
 {
 public:
-    explicit TouchScreenOneFingerEdgeGesture(QObject *parent = nullptr);
+    explicit TouchScreenOneFingerEdgeGesture(TouchScreenGestureManager *manager = nullptr);
 
     virtual int finger() {return 1;}
 
     virtual GestureType type() {return Edge;}
 
-    virtual State handleInputEvent(libinput_event *event);
+    virtual State handleInputEvent(const TouchFrame &frame);
+
+    // no frame event is used.
+    virtual bool acceptsEvent(TouchFrame::EventType type, int fingerCount) {
+        return type != TouchFrame::Frame && TouchScreenGestureInterface::acceptsEvent(type, fingerCount);
+    }
 
     virtual Direction totalDirection();
 
@@ -51,8 +56,6 @@ public:
     int longestDistance();
 
 private:
-    int m_fingerCount = 0;
-
     Direction m_direction = None;
     bool m_isCancelled = false;
 
@@ -22,37 +22,30 @@
 
 #include "touch-screen-two-finger-drag-and-tap-gesture.h"
 
-TouchScreenTwoFingerDragAndTapGesture::TouchScreenTwoFingerDragAndTapGesture(QObject *parent) : TouchScreenGestureInterface(parent)
+TouchScreenTwoFingerDragAndTapGesture::TouchScreenTwoFingerDragAndTapGesture(TouchScreenGestureManager *manager) : TouchScreenGestureInterface(manager)
 {
 
 }
 
-TouchScreenGestureInterface::State TouchScreenTwoFingerDragAndTapGesture::handleInputEvent(libinput_event *event)
+TouchScreenGestureInterface::State TouchScreenTwoFingerDragAndTapGesture::handleInputEvent(const TouchFrame &frame)
 {
-    switch (libinput_event_get_type(event)) {
-    case LIBINPUT_EVENT_TOUCH_DOWN: {
-        m_currentFingerCount++;
-        if (m_currentFingerCount > 2) {
+    switch (frame.type) {
+    case TouchFrame::Down: {
+        if (frame.fingerCount > 2) {
             m_isCancelled = true;
             return Cancelled;
         }
-        switch (m_currentFingerCount) {
+        switch (frame.fingerCount) {
         case 1: {
-            auto touch_event = libinput_event_get_touch_event(event);
-            auto xmm = libinput_event_touch_get_x(touch_event);
-            auto ymm = libinput_event_touch_get_y(touch_event);
-            m_firstPoint = QPointF(xmm, ymm);
+            m_firstPoint = frame.position(frame.slot);
             m_firstFingerStartPos = m_firstPoint;
             break;
         }
         case 2: {
-            auto touch_event = libinput_event_get_touch_event(event);
-            auto xmm = libinput_event_touch_get_x(touch_event);
-            auto ymm = libinput_event_touch_get_y(touch_event);
-            m_secondPoint = QPointF(xmm, ymm);
+            m_secondPoint = frame.position(frame.slot);
             m_secondFingerStartPos = m_secondPoint;
 
-            m_lastSecondFingerPressedTime = libinput_event_touch_get_time(touch_event);
+            m_lastSecondFingerPressedTime = frame.time / 1000;
             m_isStarted = true;
             return Maybe;
             break;
@@ -62,31 +55,26 @@ TouchScreenGestureInterface::State TouchScreenTwoFingerDragAndTapGesture::handle
         }
         break;
     }
-    case LIBINPUT_EVENT_TOUCH_MOTION: {
+    case TouchFrame::Motion: {
         if (m_isCancelled)
             return Ignore;
-        auto touch_event = libinput_event_get_touch_event(event);
-        auto xmm = libinput_event_touch_get_x(touch_event);
-        auto ymm = libinput_event_touch_get_y(touch_event);
-        auto current_slot = libinput_event_touch_get_slot(touch_event);
+        auto current_slot = frame.slot;
         if (current_slot == 0)
-            m_firstPoint = QPointF(xmm, ymm);
+            m_firstPoint = frame.position(current_slot);
         break;
     }
-    case LIBINPUT_EVENT_TOUCH_UP: {
-        m_currentFingerCount--;
+    case TouchFrame::Up: {
         if (m_isCancelled) {
             return Ignore;
         }
-        switch (m_currentFingerCount) {
+        switch (frame.fingerCount) {
         case 1: {
-            auto touch_event = libinput_event_get_touch_event(event);
-            auto timeInterval = libinput_event_touch_get_time(touch_event) - m_lastSecondFingerPressedTime;
+            auto timeInterval = frame.time / 1000 - m_lastSecondFingerPressedTime;
             auto distance = (m_secondPoint - m_firstPoint).manhattanLength();
             auto firstFingerDelta = (m_firstPoint - m_firstFingerStartPos).manhattanLength();
             auto secondFingerDelta = (m_secondPoint - m_secondFingerStartPos).manhattanLength();
             if (timeInterval < 300 && distance < 50 && !m_isCancelled && firstFingerDelta > 10 && secondFingerDelta < 10) {
-                emit gestureUpdate(getGestureIndex());
+                gestureUpdate();
                 return Update;
             }
             break;
@@ -96,7 +84,7 @@ TouchScreenGestureInterface::State TouchScreenTwoFingerDragAndTapGesture::handle
                 return Ignore;
             }
             if (m_isStarted) {
-                emit gestureFinished(getGestureIndex());
+                gestureFinished();
                 return Finished;
             }
             break;
@@ -129,7 +117,7 @@ void TouchScreenTwoFingerDragAndTapGesture::reset()
 void TouchScreenTwoFingerDragAndTapGesture::cancel()
 {
     m_isCancelled = true;
-    emit gestureCancelled(getGestureIndex());
+    gestureCancelled();
 }
 
 bool TouchScreenTwoFingerDragAndTapGesture::isCancelled()
@@ -30,13 +30,18 @@
 class TouchScreenTwoFingerDragAndTapGesture : public TouchScreenGestureInterface
 {
 public:
-    explicit TouchScreenTwoFingerDragAndTapGesture(QObject *parent = nullptr);
+    explicit TouchScreenTwoFingerDragAndTapGesture(TouchScreenGestureManager *manager = nullptr);
 
     int finger() override {return 2;}
 
     GestureType type() override {return DragAndTap;}
 
-    State handleInputEvent(libinput_event *event) override;
+    State handleInputEvent(const TouchFrame &frame) override;
+
+    // no frame event is used.
+    bool acceptsEvent(TouchFrame::EventType type, int fingerCount) override {
+        return type != TouchFrame::Frame && TouchScreenGestureInterface::acceptsEvent(type, fingerCount);
+    }
 
     void reset() override;
 
@@ -49,8 +54,7 @@ public:
     bool isCancelled() override;
 
 private:
-    int m_currentFingerCount = 0;
-    int m_lastSecondFingerPressedTime = 0;
+    quint64 m_lastSecondFingerPressedTime = 0;
 
     QPointF m_firstPoint;
     QPointF m_secondPoint;
@@ -24,29 +24,24 @@
 
 //#include <QDebug>
 
-TouchScreenTwoFingerSwipeGesture::TouchScreenTwoFingerSwipeGesture(QObject *parent)
+TouchScreenTwoFingerSwipeGesture::TouchScreenTwoFingerSwipeGesture(TouchScreenGestureManager *manager) : TouchScreenGestureInterface(manager)
 {
 
 }
 
-TouchScreenGestureInterface::State TouchScreenTwoFingerSwipeGesture::handleInputEvent(libinput_event *event)
+TouchScreenGestureInterface::State TouchScreenTwoFingerSwipeGesture::handleInputEvent(const TouchFrame &frame)
 {
-    switch (libinput_event_get_type(event)) {
-    case LIBINPUT_EVENT_TOUCH_DOWN: {
-        m_currentFingerCount++;
+    switch (frame.type) {
+    case TouchFrame::Down: {
         if (m_isCancelled)
             return Ignore;
-        auto touch_event = libinput_event_get_touch_event(event);
 
-        int current_finger_count = m_currentFingerCount;
+        int current_finger_count = frame.fingerCount;
         //qDebug()<<"current finger count:"<<current_finger_count;
-        int current_slot = libinput_event_touch_get_slot(touch_event);
+        int current_slot = frame.slot;
 
-        double mmx = libinput_event_touch_get_x(touch_event);
-        double mmy = libinput_event_touch_get_y(touch_event);
-
-        if (current_finger_count <= 2) {
-            m_startPoints[current_slot] = QPointF(mmx, mmy);
+        if (current_finger_count <= 2 && current_slot < 2) {
+            m_startPoints[current_slot] = frame.position(current_slot);
         }
 
         if (current_finger_count == 2) {
@@ -57,30 +52,27 @@ TouchScreenGestureInterface::State TouchScreenTwoFingerSwipeGesture::handleInput
                 m_currentPoints[i] = m_startPoints[i];
                 //qDebug()<<m_startPoints[i]<<m_currentPoints[i];
             }
-            emit gestureBegin(getGestureIndex());
+            gestureBegin();
             return Maybe;
         }
 
         if (current_finger_count > 2) {
             m_isCancelled = true;
-            emit gestureCancelled(getGestureIndex());
+            gestureCancelled();
             return Cancelled;
         }
         break;
     }
-    case LIBINPUT_EVENT_TOUCH_MOTION: {
+    case TouchFrame::Motion: {
         if (m_isCancelled)
             return Ignore;
 
         // update position
-        auto touch_event = libinput_event_get_touch_event(event);
-
-        int current_slot = libinput_event_touch_get_slot(touch_event);
-
-        double mmx = libinput_event_touch_get_x(touch_event);
-        double mmy = libinput_event_touch_get_y(touch_event);
+        int current_slot = frame.slot;
+        if (current_slot >= 2)
+            return Ignore;
 
-        m_currentPoints[current_slot] = QPointF(mmx, mmy);
+        m_currentPoints[current_slot] = frame.position(current_slot);
 
         if (!m_isStarted) {
             m_startPoints[current_slot] = m_currentPoints[current_slot];
@@ -90,14 +82,18 @@ TouchScreenGestureInterface::State TouchScreenTwoFingerSwipeGesture::handleInput
 
         break;
     }
-    case LIBINPUT_EVENT_TOUCH_UP: {
-        m_currentFingerCount--;
+    case TouchFrame::Up: {
         //m_isCancelled = true;
-        int current_finger_count = m_currentFingerCount;
+        int current_finger_count = frame.fingerCount;
+
+        // the velocity when the first finger is released, for kinetic scrolling.
+        if (current_finger_count == 1 && m_isStarted && !m_isCancelled) {
+            m_releaseVelocity = QPointF((frame.vx[0] + frame.vx[1]) / 2, (frame.vy[0] + frame.vy[1]) / 2);
+        }
 
         if (current_finger_count <= 0) {
             if (!m_isCancelled && m_isStarted && m_lastDirection != None) {
-                emit gestureFinished(getGestureIndex());
+                gestureFinished();
                 //qDebug()<<"total direction:"<<totalDirection();
                 return Finished;
             } else {
@@ -109,11 +105,11 @@ TouchScreenGestureInterface::State TouchScreenTwoFingerSwipeGesture::handleInput
 
         break;
     }
-    case LIBINPUT_EVENT_TOUCH_FRAME: {
+    case TouchFrame::Frame: {
         if (m_isCancelled || !m_isStarted)
             return Ignore;
 
-        if (m_currentFingerCount != 2)
+        if (frame.fingerCount != 2)
             return Ignore;
 
         // update gesture
@@ -126,7 +122,8 @@ TouchScreenGestureInterface::State TouchScreenTwoFingerSwipeGesture::handleInput
 
         //qDebug()<<"offset"<<offset;
 
-        if (offset < 20) {
+        // once scrolling, follow every millimeter for smooth scrolling.
+        if (offset < (m_lastDirection == None? 20: 1)) {
             return Ignore;
         }
 
@@ -141,16 +138,17 @@ TouchScreenGestureInterface::State TouchScreenTwoFingerSwipeGesture::handleInput
         }
 
         m_lastOffset = delta;
+        m_lastDelta = offset;
 
-        emit gestureUpdate(getGestureIndex());
+        gestureUpdate();
 
         return Update;
 
         break;
     }
-    case LIBINPUT_EVENT_TOUCH_CANCEL: {
+    case TouchFrame::Cancel: {
         m_isCancelled = true;
-        emit gestureCancelled(getGestureIndex());
+        gestureCancelled();
         return Cancelled;
         break;
     }
@@ -166,6 +164,8 @@ void TouchScreenTwoFingerSwipeGesture::reset()
     m_isCancelled = false;
     m_isStarted = false;
     m_lastDirection = None;
+    m_lastDelta = 0;
+    m_releaseVelocity = QPointF();
 
     for (int i = 0; i < 2; i++) {
         m_startPoints[i] = QPointF();
@@ -200,7 +200,7 @@ TouchScreenGestureInterface::Direction TouchScreenTwoFingerSwipeGesture::lastDir
 void TouchScreenTwoFingerSwipeGesture::cancel()
 {
     m_isCancelled = true;
-    emit gestureCancelled(getGestureIndex());
+    gestureCancelled();
 }
 
 QPointF TouchScreenTwoFingerSwipeGesture::getLastOffset()
@@ -208,3 +208,8 @@ QPointF TouchScreenTwoFingerSwipeGesture::getLastOffset()
     return m_lastOffset;
 }
 
+QPointF TouchScreenTwoFingerSwipeGesture::getReleaseVelocity()
+{
+    return m_releaseVelocity;
+}
+
@@ -30,13 +30,13 @@
 class TouchScreenTwoFingerSwipeGesture : public TouchScreenGestureInterface
 {
 public:
-    explicit TouchScreenTwoFingerSwipeGesture(QObject *parent = nullptr);
+    explicit TouchScreenTwoFingerSwipeGesture(TouchScreenGestureManager *manager = nullptr);
 
     int finger() override {return 2;}
 
     GestureType type() override {return Swipe;}
 
-    State handleInputEvent(libinput_event *event) override;
+    State handleInputEvent(const TouchFrame &frame) override;
 
     void reset() override;
 
@@ -44,25 +44,34 @@ public:
 
     Direction lastDirection() override;
 
+    double lastDelta() override {return m_lastDelta;}
+
     void cancel() override;
 
     bool isCancelled() override {return m_isCancelled;}
 
     QPointF getLastOffset();
 
-private:
-    int m_currentFingerCount = 0;
+    /*!
+     * \brief getReleaseVelocity
+     * \return the velocity of the fingers when the first one is released,
+     * in mm/s.
+     */
+    QPointF getReleaseVelocity();
 
+private:
     bool m_isCancelled = false;
     bool m_isStarted = false;
 
     Direction m_lastDirection = None;
+    double m_lastDelta = 0;
 
     QPointF m_startPoints[2];
     QPointF m_lastPoints[2];
     QPointF m_currentPoints[2];
 
     QPointF m_lastOffset;
+    QPointF m_releaseVelocity;
 };
 
 #endif // TOUCHSCREENTWOFINGERSWIPEGESTURE_H
@@ -1,29 +1,36 @@
 HEADERS += \
-    $$PWD/touch-screen-five-finger-swipe-gesture.h \
-    $$PWD/touch-screen-five-finger-zoom-gesture.h \
-    $$PWD/touch-screen-four-finger-swipe-gesture.h \
-    $$PWD/touch-screen-four-finger-zoom-gesture.h \
+    $$PWD/kinetic-scroller.h \
+    $$PWD/touch-frame.h \
+    $$PWD/touch-point-filter.h \
+    $$PWD/touch-point-kernels.h \
     $$PWD/touch-screen-gesture-interface.h \
     $$PWD/touch-screen-gesture-manager.h \
+    $$PWD/touch-screen-gesture-signal-adapter.h \
+    $$PWD/touch-screen-multi-finger-flick-gesture.h \
+    $$PWD/touch-screen-multi-finger-hold-gesture.h \
+    $$PWD/touch-screen-multi-finger-rotate-gesture.h \
+    $$PWD/touch-screen-multi-finger-swipe-gesture.h \
+    $$PWD/touch-screen-multi-finger-tap-gesture.h \
+    $$PWD/touch-screen-multi-finger-zoom-gesture.h \
     $$PWD/touch-screen-one-finger-edge-gesture.h \
-    $$PWD/touch-screen-three-finger-swipe-gesture.h \
-    $$PWD/touch-screen-three-finger-zoom-gesture.h \
     $$PWD/touch-screen-two-finger-drag-and-tap-gesture.h \
     $$PWD/touch-screen-two-finger-swipe-gesture.h \
-    $$PWD/touch-screen-two-finger-tap-gesture.h \
-    $$PWD/touch-screen-two-finger-zoom-gesture.h
+    $$PWD/touch-velocity-tracker.h
 
 SOURCES += \
-    $$PWD/touch-screen-five-finger-swipe-gesture.cpp \
-    $$PWD/touch-screen-five-finger-zoom-gesture.cpp \
-    $$PWD/touch-screen-four-finger-swipe-gesture.cpp \
-    $$PWD/touch-screen-four-finger-zoom-gesture.cpp \
+    $$PWD/kinetic-scroller.cpp \
+    $$PWD/touch-frame.cpp \
+    $$PWD/touch-point-filter.cpp \
     $$PWD/touch-screen-gesture-interface.cpp \
     $$PWD/touch-screen-gesture-manager.cpp \
+    $$PWD/touch-screen-gesture-signal-adapter.cpp \
+    $$PWD/touch-screen-multi-finger-flick-gesture.cpp \
+    $$PWD/touch-screen-multi-finger-hold-gesture.cpp \
+    $$PWD/touch-screen-multi-finger-rotate-gesture.cpp \
+    $$PWD/touch-screen-multi-finger-swipe-gesture.cpp \
+    $$PWD/touch-screen-multi-finger-tap-gesture.cpp \
+    $$PWD/touch-screen-multi-finger-zoom-gesture.cpp \
     $$PWD/touch-screen-one-finger-edge-gesture.cpp \
-    $$PWD/touch-screen-three-finger-swipe-gesture.cpp \
-    $$PWD/touch-screen-three-finger-zoom-gesture.cpp \
     $$PWD/touch-screen-two-finger-drag-and-tap-gesture.cpp \
     $$PWD/touch-screen-two-finger-swipe-gesture.cpp \
-    $$PWD/touch-screen-two-finger-tap-gesture.cpp \
-    $$PWD/touch-screen-two-finger-zoom-gesture.cpp
+    $$PWD/touch-velocity-tracker.cpp
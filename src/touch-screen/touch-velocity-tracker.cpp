@@ -0,0 +1,97 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include "touch-velocity-tracker.h"
+
+void TouchVelocityTracker::reset()
+{
+    m_head = 0;
+    m_count = 0;
+}
+
+void TouchVelocityTracker::addSample(quint64 time, float x, float y)
+{
+    m_time[m_head] = time;
+    m_x[m_head] = x;
+    m_y[m_head] = y;
+    m_head = (m_head + 1) & (TOUCH_VELOCITY_SAMPLES - 1);
+    if (m_count < TOUCH_VELOCITY_SAMPLES)
+        m_count++;
+}
+
+bool TouchVelocityTracker::estimate(quint64 time, float &vx, float &vy) const
+{
+    vx = 0;
+    vy = 0;
+
+    // the times relative to the estimated time, in seconds.
+    double t[TOUCH_VELOCITY_SAMPLES];
+    float x[TOUCH_VELOCITY_SAMPLES];
+    float y[TOUCH_VELOCITY_SAMPLES];
+    int count = 0;
+
+    // from the newest sample.
+    for (int i = 1; i <= m_count; i++) {
+        int current = (m_head - i) & (TOUCH_VELOCITY_SAMPLES - 1);
+        if (m_time[current] > time)
+            continue;
+        if (time - m_time[current] > TOUCH_VELOCITY_WINDOW)
+            break;
+        t[count] = -double(time - m_time[current]) / 1000000;
+        x[count] = m_x[current];
+        y[count] = m_y[current];
+        count++;
+    }
+
+    if (count < 2)
+        return false;
+
+    double meanT = 0;
+    double meanX = 0;
+    double meanY = 0;
+    for (int i = 0; i < count; i++) {
+        meanT += t[i];
+        meanX += x[i];
+        meanY += y[i];
+    }
+    meanT /= count;
+    meanX /= count;
+    meanY /= count;
+
+    double tt = 0;
+    double tx = 0;
+    double ty = 0;
+    for (int i = 0; i < count; i++) {
+        double dt = t[i] - meanT;
+        tt += dt * dt;
+        tx += dt * (x[i] - meanX);
+        ty += dt * (y[i] - meanY);
+    }
+
+    // all the samples have the same time.
+    if (tt <= 0)
+        return false;
+
+    vx = tx / tt;
+    vy = ty / tt;
+    return true;
+}
@@ -0,0 +1,64 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#ifndef TOUCHVELOCITYTRACKER_H
+#define TOUCHVELOCITYTRACKER_H
+
+#include <QtGlobal>
+
+// the recent samples kept for each contact, must be a power of 2.
+#define TOUCH_VELOCITY_SAMPLES 8
+// the samples older than this are not used, in usec.
+#define TOUCH_VELOCITY_WINDOW 100000
+
+/*!
+ * \brief The TouchVelocityTracker class
+ * keeps the recent positions of a contact in a ring buffer, and estimates
+ * the velocity by a least squares fit of them. A contact which stopped
+ * moving before the estimated time has no velocity, because its samples
+ * are out of the window.
+ */
+class TouchVelocityTracker
+{
+public:
+    void reset();
+
+    void addSample(quint64 time, float x, float y);
+
+    /*!
+     * \brief estimate
+     * \param time the samples in TOUCH_VELOCITY_WINDOW before it are used.
+     * \param vx in mm/s
+     * \param vy in mm/s
+     * \return false if there are less than 2 samples in the window.
+     */
+    bool estimate(quint64 time, float &vx, float &vy) const;
+
+private:
+    quint64 m_time[TOUCH_VELOCITY_SAMPLES] = {};
+    float m_x[TOUCH_VELOCITY_SAMPLES] = {};
+    float m_y[TOUCH_VELOCITY_SAMPLES] = {};
+    int m_head = 0; // the next sample is written to
+    int m_count = 0;
+};
+
+#endif // TOUCHVELOCITYTRACKER_H
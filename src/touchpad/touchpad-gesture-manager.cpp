@@ -24,23 +24,17 @@
 
 #include "settings-manager.h"
 #include "uinput-helper.h"
+#include "latency-tracker.h"
 
+#include <QMetaEnum>
 #include <QDebug>
 
-static TouchpadGestureManager *instance = nullptr;
-
-TouchpadGestureManager *TouchpadGestureManager::getManager()
-{
-    if (!instance)
-        instance = new TouchpadGestureManager;
-    return instance;
-}
-
 void TouchpadGestureManager::processEvent(libinput_event *event)
 {
     // Fixme:
     auto type = libinput_event_get_type(event);
     libinput_event_gesture *t = libinput_event_get_gesture_event(event);
+    m_eventTime = libinput_event_gesture_get_time_usec(t);
 
     switch (type) {
     case LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN: {
@@ -127,15 +121,28 @@ void TouchpadGestureManager::processEvent(libinput_event *event)
     }
     case LIBINPUT_EVENT_GESTURE_PINCH_UPDATE: {
         m_totalScale = libinput_event_gesture_get_scale(t);
-        m_totalAngle += libinput_event_gesture_get_angle_delta(t); // useless now
-        qDebug()<<m_totalScale;
+        double angle = libinput_event_gesture_get_angle_delta(t);
+        m_totalAngle += angle;
+        m_lastAngle += angle;
 
         if (m_lastScale < 0) {
             m_lastScale = m_totalScale;
             break;
         }
 
+        if (!m_isPinchTypeLocked || m_pinchType == Rotate) {
+            if (qAbs(m_lastAngle) > 15) {
+                m_pinchType = Rotate;
+                m_isPinchTypeLocked = true;
+                emit eventTriggered(Rotate, m_lastFinger, Update, m_lastAngle > 0? RotateClockwise: RotateCounterClockwise);
+                m_lastAngle = 0;
+            }
+            if (m_pinchType == Rotate)
+                break;
+        }
+
         if (qMax(m_totalScale/m_lastScale, m_lastScale/m_totalScale) > 1.5) {
+            m_isPinchTypeLocked = true;
             if (m_totalScale > m_lastScale) {
                 // zoom in
                 emit eventTriggered(Pinch, m_lastFinger, Update, ZoomIn);
@@ -152,6 +159,16 @@ void TouchpadGestureManager::processEvent(libinput_event *event)
         m_isCancelled = libinput_event_gesture_get_cancelled(t);
         m_lastFinger = libinput_event_gesture_get_finger_count(t);
 
+        if (m_pinchType == Rotate) {
+            if (!m_isCancelled && qAbs(m_totalAngle) > 20) {
+                emit eventTriggered(Rotate, m_lastFinger, Finished, m_totalAngle > 0? RotateClockwise: RotateCounterClockwise);
+            } else {
+                emit eventTriggered(Rotate, m_lastFinger, Cancelled, None);
+            }
+            reset();
+            break;
+        }
+
         // some zoom out gesture is easy to be recognized as cancelled,
         // so take them into judgement.
         if (!m_isCancelled || m_totalScale != 0) {
@@ -166,6 +183,23 @@ void TouchpadGestureManager::processEvent(libinput_event *event)
         reset();
         break;
     }
+#ifdef HAVE_LIBINPUT_HOLD_GESTURES
+    case LIBINPUT_EVENT_GESTURE_HOLD_BEGIN: {
+        // libinput begins a hold once the fingers rest long enough.
+        reset();
+        m_lastFinger = libinput_event_gesture_get_finger_count(t);
+        emit eventTriggered(Hold, m_lastFinger, Begin, None);
+        break;
+    }
+    case LIBINPUT_EVENT_GESTURE_HOLD_END: {
+        // cancelled if the fingers move, and become another gesture.
+        m_isCancelled = libinput_event_gesture_get_cancelled(t);
+        m_lastFinger = libinput_event_gesture_get_finger_count(t);
+        emit eventTriggered(Hold, m_lastFinger, m_isCancelled? Cancelled: Finished, None);
+        reset();
+        break;
+    }
+#endif
     default:
         break;
     }
@@ -188,6 +222,9 @@ void TouchpadGestureManager::reset()
 
     m_lastScale = -1;
     m_lastAngle = 0;
+
+    m_pinchType = Pinch;
+    m_isPinchTypeLocked = false;
 }
 
 void TouchpadGestureManager::onEventTriggerd(TouchpadGestureManager::GestureType type, int fingerCount, TouchpadGestureManager::State state, TouchpadGestureManager::Direction direction)
@@ -196,11 +233,24 @@ void TouchpadGestureManager::onEventTriggerd(TouchpadGestureManager::GestureType
     qDebug()<<m_totalDxmm<<m_totalDymm<<m_totalAngle<<m_totalScale;
 
     auto shortcut = SettingsManager::getManager()->gesShortCut(fingerCount, type, state, direction);
-    UInputHelper::getInstance()->executeShortCut(shortcut);
+    m_output->executeShortCut(shortcut);
+    if (!shortcut.isEmpty() && fingerCount >= 0 && fingerCount <= TOUCHPAD_MAX_FINGERS)
+        LatencyTracker::getTracker()->record(m_latencyHistograms[type][fingerCount], m_eventTime);
 }
 
-TouchpadGestureManager::TouchpadGestureManager(QObject *parent) : QObject(parent)
+TouchpadGestureManager::TouchpadGestureManager(UInputHelper *output, QObject *parent) : QObject(parent)
 {
+    m_output = output;
+
+    auto tracker = LatencyTracker::getTracker();
+    auto types = QMetaEnum::fromType<GestureType>();
+    for (int type = Swipe; type <= Hold; type++) {
+        for (int fingerCount = 0; fingerCount <= TOUCHPAD_MAX_FINGERS; fingerCount++) {
+            QString name = QString("touchpad %1 finger %2").arg(fingerCount).arg(types.valueToKey(type));
+            m_latencyHistograms[type][fingerCount] = tracker->registerHistogram(name);
+        }
+    }
+
     qRegisterMetaType<GestureType>("GestureType");
     qRegisterMetaType<State>("State");
     qRegisterMetaType<Direction>("Direction");
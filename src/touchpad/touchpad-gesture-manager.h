@@ -27,13 +27,20 @@
 
 #include <libinput.h>
 
+// the latency histograms are registered for the finger counts up to it.
+#define TOUCHPAD_MAX_FINGERS 5
+
+class UInputHelper;
+
 class TouchpadGestureManager : public QObject
 {
     Q_OBJECT
 public:
     enum GestureType {
         Swipe,
-        Pinch
+        Pinch,
+        Rotate, // a pinch which rotates more than it zooms
+        Hold
     };
     Q_ENUM(GestureType)
 
@@ -52,11 +59,17 @@ public:
         Up,
         Down,
         ZoomIn,
-        ZoomOut
+        ZoomOut,
+        RotateClockwise,
+        RotateCounterClockwise
     };
     Q_ENUM(Direction)
 
-    static TouchpadGestureManager *getManager();
+    /*!
+     * \param output the virtual device of the seat, which the shortcuts
+     * are executed by.
+     */
+    explicit TouchpadGestureManager(UInputHelper *output, QObject *parent = nullptr);
 
 signals:
     void eventTriggered(GestureType type, int fingerCount, State state, Direction direction);
@@ -68,7 +81,12 @@ public slots:
     void onEventTriggerd(GestureType type, int fingerCount, State state, Direction direction);
 
 private:
-    explicit TouchpadGestureManager(QObject *parent = nullptr);
+    UInputHelper *m_output = nullptr;
+
+    // the timestamp of the event which is being handled, in usec.
+    quint64 m_eventTime = 0;
+    // the LatencyTracker indexes by the gesture type and finger count.
+    int m_latencyHistograms[Hold + 1][TOUCHPAD_MAX_FINGERS + 1];
 
     int m_lastFinger = 0;
     bool m_isCancelled = 0;
@@ -83,7 +101,11 @@ private:
     double m_lastAngle = 0;
 
     double m_totalScale = 0;
-    double m_totalAngle = 0;
+    double m_totalAngle = 0; // in degrees, clockwise
+
+    // a pinch is taken as the first one of zoom and rotate updated.
+    GestureType m_pinchType = Pinch;
+    bool m_isPinchTypeLocked = false;
 };
 
 #endif // TOUCHPADGESTUREMANAGER_H
@@ -26,24 +26,18 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <string.h>
+#include <sys/ioctl.h>
 #include <linux/uinput.h>
 #include <linux/input.h>
 
 #include <QDebug>
 
-static struct uinput_user_dev uinput_dev;
-static int uinput_fd;
-
-int creat_user_uinput(void);
-int post_event(unsigned int type, unsigned int keycode, unsigned int value);
-
-static UInputHelper *instance = nullptr;
-
-UInputHelper *UInputHelper::getInstance()
+UInputHelper::~UInputHelper()
 {
-    if (!instance)
-        instance = new UInputHelper;
-    return instance;
+    if (m_fd >= 0) {
+        ioctl(m_fd, UI_DEV_DESTROY);
+        close(m_fd);
+    }
 }
 
 void UInputHelper::executeShortCut(const QKeySequence &shortCut)
@@ -52,30 +46,73 @@ void UInputHelper::executeShortCut(const QKeySequence &shortCut)
     qDebug()<<list;
     auto keys = parseShortcut(shortCut);
     for (auto key: keys) {
-        int ret = post_event(EV_KEY, key, 1);
+        int ret = postEvent(EV_KEY, key, 1);
         if (ret != 0) {
             qDebug()<<"failed, try recreate uinput";
-            creat_user_uinput();
-            post_event(EV_KEY, key, 1);
+            createDevice();
+            postEvent(EV_KEY, key, 1);
         }
     }
     for (auto key: keys) {
-        post_event(EV_KEY, key, 0);
+        postEvent(EV_KEY, key, 0);
     }
 }
 
 void UInputHelper::clickMouseRightButton()
 {
     qDebug()<<"mouse click";
-    post_event(EV_KEY, BTN_RIGHT, 1);
-    post_event(EV_KEY, BTN_RIGHT, 0);
+    postEvent(EV_KEY, BTN_RIGHT, 1);
+    postEvent(EV_KEY, BTN_RIGHT, 0);
 }
 
 void UInputHelper::wheel(QPointF offset)
 {
-    qDebug()<<"wheel"<<offset;
-    post_event(EV_REL, REL_WHEEL, offset.toPoint().y());
-    post_event(EV_REL, REL_HWHEEL, -offset.toPoint().x());
+    // the horizontal wheel is reversed.
+    int hiResX = accumulateWheel(-offset.x(), m_hiResRemainderX, m_notchRemainderX);
+    int hiResY = accumulateWheel(offset.y(), m_hiResRemainderY, m_notchRemainderY);
+
+    struct input_event events[4];
+    int count = 0;
+    auto append = [&](unsigned int code, int value) {
+        memset(&events[count], 0, sizeof(struct input_event));
+        events[count].type = EV_REL;
+        events[count].code = code;
+        events[count].value = value;
+        count++;
+    };
+
+#ifdef REL_WHEEL_HI_RES
+    if (hiResY != 0)
+        append(REL_WHEEL_HI_RES, hiResY);
+    if (hiResX != 0)
+        append(REL_HWHEEL_HI_RES, hiResX);
+#endif
+
+    // the legacy events are only sent when a whole notch is crossed.
+    int notchesY = m_notchRemainderY / WHEEL_HI_RES_PER_NOTCH;
+    int notchesX = m_notchRemainderX / WHEEL_HI_RES_PER_NOTCH;
+    m_notchRemainderY -= notchesY * WHEEL_HI_RES_PER_NOTCH;
+    m_notchRemainderX -= notchesX * WHEEL_HI_RES_PER_NOTCH;
+    if (notchesY != 0)
+        append(REL_WHEEL, notchesY);
+    if (notchesX != 0)
+        append(REL_HWHEEL, notchesX);
+
+    postEvents(events, count);
+}
+
+int UInputHelper::accumulateWheel(double notches, double &hiResRemainder, int &notchRemainder)
+{
+    hiResRemainder += notches * WHEEL_HI_RES_PER_NOTCH;
+    int hiRes = int(hiResRemainder);
+    hiResRemainder -= hiRes;
+
+    // start a new notch when the direction changed.
+    if ((hiRes > 0 && notchRemainder < 0) || (hiRes < 0 && notchRemainder > 0))
+        notchRemainder = 0;
+    notchRemainder += hiRes;
+
+    return hiRes;
 }
 
 QList<int> UInputHelper::parseShortcut(const QKeySequence &shortCut)
@@ -98,9 +135,13 @@ QList<int> UInputHelper::parseShortcut(const QKeySequence &shortCut)
     return keys;
 }
 
-UInputHelper::UInputHelper(QObject *parent) : QObject(parent)
+UInputHelper::UInputHelper(const QString &seat, QObject *parent) : QObject(parent)
 {
-    int ret = creat_user_uinput();
+    m_deviceName = "uinput-custom-dev";
+    if (seat != "seat0")
+        m_deviceName += "-" + seat;
+
+    int ret = createDevice();
     if (ret < 0) {
         qErrnoWarning(ret, "can't create uinput device, exit");
         exit(ret);
@@ -183,75 +224,107 @@ UInputHelper::UInputHelper(QObject *parent) : QObject(parent)
     m_hash.insert("F12", KEY_F12);
 }
 
-int creat_user_uinput(void)
+int UInputHelper::createDevice()
 {
+    struct uinput_user_dev uinput_dev;
     int i;
     int ret = 0;
 
-    uinput_fd = open("/dev/uinput", O_RDWR | O_NDELAY);
-    if(uinput_fd < 0){
+    if (m_fd >= 0)
+        close(m_fd);
+
+    m_fd = open("/dev/uinput", O_RDWR | O_NDELAY | O_CLOEXEC);
+    if(m_fd < 0){
         printf("%s:%d\n", __func__, __LINE__);
         return -1;//error process.
     }
 
     //to set uinput dev
     memset(&uinput_dev, 0, sizeof(struct uinput_user_dev));
-    snprintf(uinput_dev.name, UINPUT_MAX_NAME_SIZE, "uinput-custom-dev");
+    snprintf(uinput_dev.name, UINPUT_MAX_NAME_SIZE, "%s", m_deviceName.toLocal8Bit().constData());
     uinput_dev.id.version = 1;
     uinput_dev.id.bustype = BUS_VIRTUAL;
 
-    ioctl(uinput_fd, UI_SET_EVBIT, EV_SYN);
-    ioctl(uinput_fd, UI_SET_EVBIT, EV_KEY);
-    ioctl(uinput_fd, UI_SET_EVBIT, EV_MSC);
+    ioctl(m_fd, UI_SET_EVBIT, EV_SYN);
+    ioctl(m_fd, UI_SET_EVBIT, EV_KEY);
+    ioctl(m_fd, UI_SET_EVBIT, EV_MSC);
 
     // mouse right click
-    ioctl(uinput_fd, UI_SET_KEYBIT, BTN_RIGHT);
+    ioctl(m_fd, UI_SET_KEYBIT, BTN_RIGHT);
 
     // wheel
-    ioctl(uinput_fd, UI_SET_EVBIT, EV_REL);
-    ioctl(uinput_fd, UI_SET_RELBIT, REL_WHEEL);
-    ioctl(uinput_fd, UI_SET_RELBIT, REL_HWHEEL);
+    ioctl(m_fd, UI_SET_EVBIT, EV_REL);
+    ioctl(m_fd, UI_SET_RELBIT, REL_WHEEL);
+    ioctl(m_fd, UI_SET_RELBIT, REL_HWHEEL);
+#ifdef REL_WHEEL_HI_RES
+    ioctl(m_fd, UI_SET_RELBIT, REL_WHEEL_HI_RES);
+    ioctl(m_fd, UI_SET_RELBIT, REL_HWHEEL_HI_RES);
+#endif
 
     for(i = 0; i < 256; i++){
-        ioctl(uinput_fd, UI_SET_KEYBIT, i);
+        ioctl(m_fd, UI_SET_KEYBIT, i);
     }
 
-    ret = write(uinput_fd, &uinput_dev, sizeof(struct uinput_user_dev));
+    ret = write(m_fd, &uinput_dev, sizeof(struct uinput_user_dev));
     if(ret < 0){
         printf("%s:%d\n", __func__, __LINE__);
         return ret;//error process.
     }
 
-    ret = ioctl(uinput_fd, UI_DEV_CREATE);
+    ret = ioctl(m_fd, UI_DEV_CREATE);
     if(ret < 0){
         printf("%s:%d\n", __func__, __LINE__);
-        //close(uinput_fd);
+        //close(m_fd);
         return ret;//error process.
     }
+
+    return 0;
+}
+
+int UInputHelper::postEvents(struct input_event *events, int count)
+{
+    if (count <= 0)
+        return 0;
+
+    // the events and the SYN_REPORT are written at once, as one frame.
+    struct input_event frame[8];
+    count = qMin(count, 7);
+    memcpy(frame, events, count * sizeof(struct input_event));
+    memset(&frame[count], 0, sizeof(struct input_event));
+    frame[count].type = EV_SYN;
+    frame[count].code = SYN_REPORT;
+    frame[count].value = 0;
+
+    int ret = write(m_fd, frame, (count + 1) * sizeof(struct input_event));
+    if (ret < 0) {
+        printf("%s failed:%d\n", __func__, __LINE__);
+        return ret;
+    }
+
+    return 0;
 }
 
-int post_event(unsigned int type, unsigned int keycode, unsigned int value)
+int UInputHelper::postEvent(unsigned int type, unsigned int keycode, unsigned int value)
 {
     struct input_event key_event;
     int ret;
 
+    // the kernel stamps the events written to uinput, leave the time zero.
     memset(&key_event, 0, sizeof(struct input_event));
 
-    gettimeofday(&key_event.time, NULL);
     key_event.type = type;
     key_event.code = keycode;
     key_event.value = value;
-    ret = write(uinput_fd, &key_event, sizeof(struct input_event));
+    ret = write(m_fd, &key_event, sizeof(struct input_event));
     if(ret < 0){
         printf("%s failed:%d\n", __func__, __LINE__);
         return ret;//error process.
     }
 
-    gettimeofday(&key_event.time, NULL);
     key_event.type = EV_SYN;
     key_event.code = SYN_REPORT;
     key_event.value = 0;//event status sync
-    ret = write(uinput_fd, &key_event, sizeof(struct input_event));
+    ret = write(m_fd, &key_event, sizeof(struct input_event));
     if(ret < 0){
         printf("%s:%d\n", __func__, __LINE__);
         return ret;//error process.
@@ -30,24 +30,64 @@
 
 #include <QPointF>
 
+// the units of the high resolution wheel for a notch, see linux/input-event-codes.h.
+#define WHEEL_HI_RES_PER_NOTCH 120
+
+struct input_event;
+
+/*!
+ * \brief The UInputHelper class
+ * owns a virtual uinput device, which the translated shortcuts and mouse
+ * events are written to. Every seat has its own device, a udev rule is
+ * needed for assigning the device of other seats than seat0, see README.
+ */
 class UInputHelper : public QObject
 {
     Q_OBJECT
 public:
-    static UInputHelper *getInstance();
+    explicit UInputHelper(const QString &seat = "seat0", QObject *parent = nullptr);
+    ~UInputHelper();
+
+    /*!
+     * \brief deviceName
+     * \return the name of the virtual device, "uinput-custom-dev" for seat0,
+     * "uinput-custom-dev-<seat>" for the others.
+     */
+    QString deviceName() const {return m_deviceName;}
 
 signals:
 
 public slots:
     void executeShortCut(const QKeySequence &shortCut);
     void clickMouseRightButton();
+    /*!
+     * \brief wheel
+     * \param offset in notches, the fractions are accumulated and sent as
+     * high resolution wheel events, the legacy ones are sent for every
+     * crossed notch.
+     */
     void wheel(QPointF offset);
 
 protected:
     QList<int> parseShortcut(const QKeySequence &shortCut);
 
 private:
-    explicit UInputHelper(QObject *parent = nullptr);
+    int createDevice();
+    int postEvent(unsigned int type, unsigned int keycode, unsigned int value);
+    int postEvents(struct input_event *events, int count);
+
+    // \return the high resolution units to send.
+    static int accumulateWheel(double notches, double &hiResRemainder, int &notchRemainder);
+
+    int m_fd = -1;
+    QString m_deviceName;
+
+    // the part of a high resolution unit which is not sent yet.
+    double m_hiResRemainderX = 0;
+    double m_hiResRemainderY = 0;
+    // the high resolution units sent since the last legacy event.
+    int m_notchRemainderX = 0;
+    int m_notchRemainderY = 0;
 
     QHash<QString, int> m_hash;
 };
@@ -0,0 +1,40 @@
+QT += testlib gui dbus
+
+TARGET = tst-evdev-replay
+
+CONFIG += c++11 console testcase link_pkgconfig
+CONFIG -= app_bundle
+
+PKGCONFIG += libinput libudev
+
+# the same as the daemon, the touchpad manager is built with the sources.
+system(pkg-config --atleast-version=1.19 libinput) {
+    DEFINES += HAVE_LIBINPUT_HOLD_GESTURES
+}
+
+SRC_DIR = $$PWD/../../src
+INCLUDEPATH += $$SRC_DIR $$SRC_DIR/touch-screen
+
+include($$SRC_DIR/touch-screen/touch-screen.pri)
+include($$SRC_DIR/touchpad/touchpad.pri)
+
+SOURCES += \
+    $$SRC_DIR/deadline-timer.cpp \
+    $$SRC_DIR/evdev-touch-source.cpp \
+    $$SRC_DIR/event-reactor.cpp \
+    $$SRC_DIR/latency-histogram.cpp \
+    $$SRC_DIR/latency-tracker.cpp \
+    $$SRC_DIR/realtime-profile.cpp \
+    $$SRC_DIR/settings-manager.cpp \
+    $$SRC_DIR/uinput-helper.cpp \
+    tst-evdev-replay.cpp
+
+HEADERS += \
+    $$SRC_DIR/deadline-timer.h \
+    $$SRC_DIR/evdev-touch-source.h \
+    $$SRC_DIR/event-reactor.h \
+    $$SRC_DIR/latency-histogram.h \
+    $$SRC_DIR/latency-tracker.h \
+    $$SRC_DIR/realtime-profile.h \
+    $$SRC_DIR/settings-manager.h \
+    $$SRC_DIR/uinput-helper.h
@@ -0,0 +1,357 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QVector>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+
+#include "evdev-touch-source.h"
+#include "touch-screen/touch-screen-multi-finger-swipe-gesture.h"
+
+// the axes of the recorded touch screen, 300x200 mm with 10 units per mm.
+#define RECORDING_SLOTS 32
+#define RECORDING_WIDTH 3000
+#define RECORDING_HEIGHT 2000
+#define RECORDING_RESOLUTION 10
+
+/*!
+ * \brief The Recording class
+ * writes the input_event of a protocol-B touch screen like the kernel does,
+ * and saves them as a recording which EvdevTouchSource can replay.
+ */
+class Recording
+{
+public:
+    void slot(int slot) {add(EV_ABS, ABS_MT_SLOT, slot);}
+    void trackingId(int id) {add(EV_ABS, ABS_MT_TRACKING_ID, id);}
+    void position(int x, int y) {
+        add(EV_ABS, ABS_MT_POSITION_X, x);
+        add(EV_ABS, ABS_MT_POSITION_Y, y);
+    }
+    void report() {
+        add(EV_SYN, SYN_REPORT, 0);
+        // 8ms per frame, as a 125Hz touch screen.
+        m_time += 8000;
+    }
+
+    /*!
+     * \brief save
+     * \param withAxes write the EvdevRecordingHeader, or a raw recording
+     * like cat /dev/input/eventX does.
+     */
+    bool save(const QString &path, bool withAxes) const;
+
+private:
+    void add(int type, int code, int value);
+
+    QVector<struct input_event> m_events;
+    quint64 m_time = 1000000;
+};
+
+void Recording::add(int type, int code, int value)
+{
+    struct input_event event;
+    memset(&event, 0, sizeof(event));
+    event.input_event_sec = m_time / 1000000;
+    event.input_event_usec = m_time % 1000000;
+    event.type = type;
+    event.code = code;
+    event.value = value;
+    m_events<<event;
+}
+
+bool Recording::save(const QString &path, bool withAxes) const
+{
+    int fd = ::open(path.toLocal8Bit().constData(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return false;
+
+    bool ok = true;
+    if (withAxes) {
+        EvdevRecordingHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, EVDEV_RECORDING_MAGIC, sizeof(header.magic));
+        header.version = EVDEV_RECORDING_VERSION;
+        header.axes[EvdevRecordingHeader::SlotAxis].maximum = RECORDING_SLOTS - 1;
+        header.axes[EvdevRecordingHeader::XAxis].maximum = RECORDING_WIDTH;
+        header.axes[EvdevRecordingHeader::XAxis].resolution = RECORDING_RESOLUTION;
+        header.axes[EvdevRecordingHeader::YAxis].maximum = RECORDING_HEIGHT;
+        header.axes[EvdevRecordingHeader::YAxis].resolution = RECORDING_RESOLUTION;
+        ok = write(fd, &header, sizeof(header)) == (ssize_t)sizeof(header);
+    }
+
+    ssize_t size = m_events.size() * sizeof(struct input_event);
+    ok = ok && write(fd, m_events.constData(), size) == size;
+    ::close(fd);
+    return ok;
+}
+
+/*!
+ * \brief The TestEvdevReplay class
+ * replays recordings through EvdevTouchSource, and checks the frames and
+ * the gestures recognized from them.
+ */
+class TestEvdevReplay : public QObject, public TouchScreenGestureSink
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void init();
+
+    void positions_data();
+    void positions();
+    void slotsOutOfFrameTable();
+    void trackingIdReplaced();
+    void swipe_data();
+    void swipe();
+
+private:
+    void onGestureBegin(int index) override {}
+    void onGestureUpdated(int index) override {}
+    void onGestureCancelled(int index) override {}
+    void onGestureFinished(int index) override;
+
+    QString replay(const Recording &recording, bool withAxes, TouchScreenGestureInterface *gesture = nullptr);
+
+    QTemporaryDir m_dir;
+    QVector<TouchFrame> m_frames;
+    TouchScreenGestureInterface *m_gesture = nullptr;
+    bool m_isFinished = false;
+    TouchScreenGestureInterface::Direction m_finishedDirection = TouchScreenGestureInterface::None;
+};
+
+void TestEvdevReplay::init()
+{
+    m_frames.clear();
+    m_gesture = nullptr;
+    m_isFinished = false;
+    m_finishedDirection = TouchScreenGestureInterface::None;
+}
+
+void TestEvdevReplay::onGestureFinished(int index)
+{
+    m_isFinished = true;
+    m_finishedDirection = m_gesture->totalDirection();
+}
+
+QString TestEvdevReplay::replay(const Recording &recording, bool withAxes, TouchScreenGestureInterface *gesture)
+{
+    QString path = m_dir.filePath(QTest::currentTestFunction());
+    if (!recording.save(path, withAxes))
+        return QString("can not write %1").arg(path);
+
+    m_gesture = gesture;
+    if (gesture)
+        gesture->setSink(this);
+
+    EvdevTouchSource source([this](const TouchFrame &frame) {
+        m_frames<<frame;
+        if (m_gesture)
+            m_gesture->handleInputEvent(frame);
+    });
+    // a raw recording falls back to device units, and says so.
+    if (!withAxes) {
+        QString warning = QString("\"%1\" has no axes, the positions are replayed in device units").arg(path);
+        QTest::ignoreMessage(QtWarningMsg, qPrintable(warning));
+    }
+    if (!source.open(path))
+        return QString("can not replay %1").arg(path);
+    if (!source.isRecording())
+        return QString("%1 is not replayed as a recording").arg(path);
+
+    source.dispatch();
+    // the source is closed at the end of the recording.
+    if (source.fd() >= 0)
+        return QString("%1 is not replayed to the end").arg(path);
+    return QString();
+}
+
+void TestEvdevReplay::positions_data()
+{
+    QTest::addColumn<bool>("withAxes");
+    QTest::addColumn<double>("x");
+    QTest::addColumn<double>("y");
+
+    QTest::newRow("axes") << true << 100.0 << 50.0;
+    QTest::newRow("raw") << false << 1000.0 << 500.0;
+}
+
+void TestEvdevReplay::positions()
+{
+    QFETCH(bool, withAxes);
+    QFETCH(double, x);
+    QFETCH(double, y);
+
+    Recording recording;
+    recording.slot(0);
+    recording.trackingId(1);
+    recording.position(1000, 500);
+    recording.report();
+
+    QString error = replay(recording, withAxes);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+
+    QCOMPARE(m_frames.size(), 2);
+    const TouchFrame &down = m_frames.first();
+    QCOMPARE(down.type, TouchFrame::Down);
+    QCOMPARE(down.fingerCount, 1);
+    QCOMPARE(double(down.x[down.slot]), x);
+    QCOMPARE(double(down.y[down.slot]), y);
+    if (withAxes) {
+        QCOMPARE(down.nx[down.slot], 1000.0f / RECORDING_WIDTH);
+        QCOMPARE(down.ny[down.slot], 500.0f / RECORDING_HEIGHT);
+    }
+    QCOMPARE(m_frames.last().type, TouchFrame::Frame);
+}
+
+void TestEvdevReplay::slotsOutOfFrameTable()
+{
+    // the device slots are beyond the frame table, they are mapped to the
+    // dense indexes from 0.
+    Recording recording;
+    for (int i = 0; i < 3; i++) {
+        recording.slot(20 + i * 5);
+        recording.trackingId(10 + i);
+        recording.position(1000 + 300 * i, 1000);
+    }
+    recording.report();
+
+    QString error = replay(recording, true);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+
+    QCOMPARE(m_frames.size(), 4);
+    for (int i = 0; i < 3; i++) {
+        const TouchFrame &down = m_frames.at(i);
+        QCOMPARE(down.type, TouchFrame::Down);
+        QCOMPARE(down.slot, i);
+        QCOMPARE(down.fingerCount, i + 1);
+        QCOMPARE(down.deviceSlot[i], 20 + i * 5);
+        QCOMPARE(double(down.x[i]), 100.0 + 30 * i);
+    }
+    QCOMPARE(m_frames.last().type, TouchFrame::Frame);
+    QCOMPARE(m_frames.last().fingerCount, 3);
+}
+
+void TestEvdevReplay::trackingIdReplaced()
+{
+    // a new tracking id in a slot without -1 in between, which is seen after
+    // SYN_DROPPED, is a new contact.
+    Recording recording;
+    recording.slot(3);
+    recording.trackingId(1);
+    recording.position(1000, 1000);
+    recording.report();
+    recording.trackingId(2);
+    recording.position(2000, 1500);
+    recording.report();
+    recording.trackingId(-1);
+    recording.report();
+
+    QString error = replay(recording, true);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+
+    QVector<TouchFrame::EventType> types;
+    for (auto frame : m_frames)
+        types<<frame.type;
+    QVector<TouchFrame::EventType> expected {
+        TouchFrame::Down, TouchFrame::Frame,
+        TouchFrame::Up, TouchFrame::Down, TouchFrame::Frame,
+        TouchFrame::Up, TouchFrame::Frame
+    };
+    QCOMPARE(types, expected);
+
+    const TouchFrame &up = m_frames.at(2);
+    QCOMPARE(up.fingerCount, 0);
+    const TouchFrame &down = m_frames.at(3);
+    QCOMPARE(down.fingerCount, 1);
+    QCOMPARE(double(down.x[down.slot]), 200.0);
+    QCOMPARE(double(down.y[down.slot]), 150.0);
+
+    // the new contact has its own index, so no index is both up and down,
+    // and the released one keeps its last position until the frame closes.
+    QVERIFY(down.slot != up.slot);
+    const TouchFrame &frame = m_frames.at(4);
+    QCOMPARE(frame.upMask, 1u << up.slot);
+    QCOMPARE(frame.downMask, 1u << down.slot);
+    QCOMPARE(frame.activeMask, 1u << down.slot);
+    QCOMPARE(double(frame.x[up.slot]), 100.0);
+    QCOMPARE(double(frame.y[up.slot]), 100.0);
+}
+
+void TestEvdevReplay::swipe_data()
+{
+    QTest::addColumn<bool>("withAxes");
+    QTest::addColumn<int>("distance");
+    QTest::addColumn<bool>("isSwipe");
+
+    // a three finger swipe needs the centroid to move 20mm.
+    QTest::newRow("40mm") << true << 400 << true;
+    QTest::newRow("15mm") << true << 150 << false;
+    // without axes the positions fall back to device units as documented,
+    // so the same 150 units are taken as 150mm.
+    QTest::newRow("raw 150 units") << false << 150 << true;
+}
+
+void TestEvdevReplay::swipe()
+{
+    QFETCH(bool, withAxes);
+    QFETCH(int, distance);
+    QFETCH(bool, isSwipe);
+
+    Recording recording;
+    for (int i = 0; i < 3; i++) {
+        recording.slot(17 + i);
+        recording.trackingId(100 + i);
+        recording.position(1000 + 150 * i, 1000);
+    }
+    recording.report();
+
+    int steps = 10;
+    for (int step = 1; step <= steps; step++) {
+        for (int i = 0; i < 3; i++) {
+            recording.slot(17 + i);
+            recording.position(1000 + 150 * i + distance * step / steps, 1000);
+        }
+        recording.report();
+    }
+
+    for (int i = 0; i < 3; i++) {
+        recording.slot(17 + i);
+        recording.trackingId(-1);
+    }
+    recording.report();
+
+    TouchScreenMultiFingerSwipeGesture<3> gesture;
+    QString error = replay(recording, withAxes, &gesture);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+
+    QCOMPARE(m_isFinished, isSwipe);
+    if (isSwipe)
+        QCOMPARE(m_finishedDirection, TouchScreenGestureInterface::Right);
+}
+
+QTEST_GUILESS_MAIN(TestEvdevReplay)
+
+#include "tst-evdev-replay.moc"
@@ -0,0 +1,5 @@
+TEMPLATE = subdirs
+SUBDIRS = \
+    evdev-replay \
+    touch-point-kernels \
+    touch-point-kernels-benchmark
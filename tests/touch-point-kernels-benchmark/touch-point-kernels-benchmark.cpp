@@ -0,0 +1,151 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include <QtTest>
+#include <QPointF>
+
+#include "touch-point-kernels.h"
+
+/*!
+ * \brief The TouchPointKernelsBenchmark class
+ * compares the kernels with the formulas the swipe and zoom recognizers
+ * used before them, which worked on arrays of QPointF. The finger count is
+ * a template parameter like in the recognizers, so both sides get the same
+ * compile time trip count.
+ */
+class TouchPointKernelsBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+
+    void centroidPoints();
+    void centroidKernel();
+    void spreadPoints();
+    void spreadKernel();
+    void rotationKernel();
+
+private:
+    template<int N>
+    static QPointF center(const QPointF (&points)[N]);
+    template<int N>
+    static double spread(const QPointF (&points)[N]);
+
+    QPointF m_points[4];
+    float m_x[4];
+    float m_y[4];
+    float m_rotatedX[4];
+    float m_rotatedY[4];
+};
+
+void TouchPointKernelsBenchmark::initTestCase()
+{
+    for (int i = 0; i < 4; i++) {
+        m_points[i] = QPointF(100 + 17 * i, 60 + 11 * (i % 3));
+        m_x[i] = m_points[i].x();
+        m_y[i] = m_points[i].y();
+        m_rotatedX[i] = m_x[i] + 0.1f * i;
+        m_rotatedY[i] = m_y[i] - 0.1f * i;
+    }
+}
+
+template<int N>
+QPointF TouchPointKernelsBenchmark::center(const QPointF (&points)[N])
+{
+    double x = 0;
+    double y = 0;
+    for (int i = 0; i < N; i++) {
+        x += points[i].x();
+        y += points[i].y();
+    }
+    return QPointF(x/N, y/N);
+}
+
+template<int N>
+double TouchPointKernelsBenchmark::spread(const QPointF (&points)[N])
+{
+    double x = 0;
+    double y = 0;
+    for (int i = 0; i < N; i++) {
+        x += points[i].x();
+        y += points[i].y();
+    }
+    x /= N;
+    y /= N;
+
+    double distance = 0;
+    for (int i = 0; i < N; i++) {
+        distance += qAbs(points[i].x() - x) + qAbs(points[i].y() - y);
+    }
+    return 2 * distance / N;
+}
+
+void TouchPointKernelsBenchmark::centroidPoints()
+{
+    QPointF result;
+    QBENCHMARK {
+        result += center<4>(m_points);
+    }
+    QVERIFY(!result.isNull());
+}
+
+void TouchPointKernelsBenchmark::centroidKernel()
+{
+    float sumX = 0;
+    QBENCHMARK {
+        float cx, cy;
+        TouchPointKernels::centroid<4>(m_x, m_y, cx, cy);
+        sumX += cx;
+    }
+    QVERIFY(sumX != 0);
+}
+
+void TouchPointKernelsBenchmark::spreadPoints()
+{
+    double result = 0;
+    QBENCHMARK {
+        result += spread<4>(m_points);
+    }
+    QVERIFY(result != 0);
+}
+
+void TouchPointKernelsBenchmark::spreadKernel()
+{
+    float result = 0;
+    QBENCHMARK {
+        result += TouchPointKernels::spread<4>(m_x, m_y);
+    }
+    QVERIFY(result != 0);
+}
+
+void TouchPointKernelsBenchmark::rotationKernel()
+{
+    float result = 0;
+    QBENCHMARK {
+        result += TouchPointKernels::rotation<4>(m_x, m_y, m_rotatedX, m_rotatedY);
+    }
+    QVERIFY(result != 0);
+}
+
+QTEST_APPLESS_MAIN(TouchPointKernelsBenchmark)
+
+#include "touch-point-kernels-benchmark.moc"
@@ -0,0 +1,14 @@
+QT += testlib
+
+TARGET = touch-point-kernels-benchmark
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+INCLUDEPATH += $$PWD/../../src/touch-screen
+
+SOURCES += \
+    touch-point-kernels-benchmark.cpp
+
+HEADERS += \
+    ../../src/touch-screen/touch-point-kernels.h
@@ -0,0 +1,15 @@
+QT += testlib
+QT -= gui
+
+TARGET = tst-touch-point-kernels
+
+CONFIG += c++11 console testcase
+CONFIG -= app_bundle
+
+INCLUDEPATH += $$PWD/../../src/touch-screen
+
+SOURCES += \
+    tst-touch-point-kernels.cpp
+
+HEADERS += \
+    ../../src/touch-screen/touch-point-kernels.h
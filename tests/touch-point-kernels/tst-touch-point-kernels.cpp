@@ -0,0 +1,264 @@
+/*
+ * Libinput Touch Translator
+ *
+ * Copyright (C) 2020, KylinSoft Co., Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Authors: Yue Lan <lanyue@kylinos.cn>
+ *
+ */
+
+#include <QtTest>
+
+#include <cmath>
+
+#include "touch-point-kernels.h"
+
+#define TOUCH_POINT_MAX_COUNT 16
+
+/*!
+ * \brief The TestTouchPointKernels class
+ * compares the vectorized kernels with a scalar reference in double for
+ * every count of points up to the slot count of a touch frame, which covers
+ * the vector body, the scalar tail and both of them.
+ */
+class TestTouchPointKernels : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+
+    void centroid_data();
+    void centroid();
+    void meanRadius_data();
+    void meanRadius();
+    void covariance_data();
+    void covariance();
+    void spread_data();
+    void spread();
+    void rotation_data();
+    void rotation();
+
+    void fixedSize();
+
+private:
+    static void addCounts();
+    static void referenceCentroid(const float *x, const float *y, int count, double &cx, double &cy);
+
+    float m_x[TOUCH_POINT_MAX_COUNT];
+    float m_y[TOUCH_POINT_MAX_COUNT];
+    float m_rotatedX[TOUCH_POINT_MAX_COUNT];
+    float m_rotatedY[TOUCH_POINT_MAX_COUNT];
+};
+
+static const double rotation_angle = 0.3;
+
+/*!
+ * \brief fuzzyEqual
+ * compares in the precision of float relative to \a scale, which is the
+ * magnitude of the terms summed up for the expected value.
+ */
+static bool fuzzyEqual(double actual, double expected, double scale = 0)
+{
+    return std::abs(actual - expected) <= 1e-5 * qMax(1.0, qMax(std::abs(expected), scale));
+}
+
+void TestTouchPointKernels::initTestCase()
+{
+    // fingers of a hand in mm, spread around (120, 80) by a fixed lcg.
+    quint32 seed = 20201016;
+    for (int i = 0; i < TOUCH_POINT_MAX_COUNT; i++) {
+        seed = seed * 1664525 + 1013904223;
+        m_x[i] = 120 + (seed >> 16) % 8000 / 100.0f - 40;
+        seed = seed * 1664525 + 1013904223;
+        m_y[i] = 80 + (seed >> 16) % 6000 / 100.0f - 30;
+    }
+
+    // rotate the points around (130, 70) and move them, so the angle is
+    // known for every count.
+    double c = std::cos(rotation_angle);
+    double s = std::sin(rotation_angle);
+    for (int i = 0; i < TOUCH_POINT_MAX_COUNT; i++) {
+        double dx = m_x[i] - 130;
+        double dy = m_y[i] - 70;
+        m_rotatedX[i] = 130 + dx * c - dy * s + 5;
+        m_rotatedY[i] = 70 + dx * s + dy * c - 3;
+    }
+}
+
+void TestTouchPointKernels::addCounts()
+{
+    QTest::addColumn<int>("count");
+    for (int count = 1; count <= TOUCH_POINT_MAX_COUNT; count++)
+        QTest::newRow(QByteArray::number(count).constData()) << count;
+}
+
+void TestTouchPointKernels::referenceCentroid(const float *x, const float *y, int count, double &cx, double &cy)
+{
+    cx = 0;
+    cy = 0;
+    for (int i = 0; i < count; i++) {
+        cx += x[i];
+        cy += y[i];
+    }
+    cx /= count;
+    cy /= count;
+}
+
+void TestTouchPointKernels::centroid_data()
+{
+    addCounts();
+}
+
+void TestTouchPointKernels::centroid()
+{
+    QFETCH(int, count);
+
+    double expectedX, expectedY;
+    referenceCentroid(m_x, m_y, count, expectedX, expectedY);
+
+    float cx, cy;
+    TouchPointKernels::centroid(m_x, m_y, count, cx, cy);
+    QVERIFY2(fuzzyEqual(cx, expectedX), qPrintable(QString("%1 != %2").arg(cx).arg(expectedX)));
+    QVERIFY2(fuzzyEqual(cy, expectedY), qPrintable(QString("%1 != %2").arg(cy).arg(expectedY)));
+}
+
+void TestTouchPointKernels::meanRadius_data()
+{
+    addCounts();
+}
+
+void TestTouchPointKernels::meanRadius()
+{
+    QFETCH(int, count);
+
+    double cx, cy;
+    referenceCentroid(m_x, m_y, count, cx, cy);
+    double expected = 0;
+    for (int i = 0; i < count; i++)
+        expected += std::hypot(m_x[i] - cx, m_y[i] - cy);
+    expected /= count;
+
+    float radius = TouchPointKernels::meanRadius(m_x, m_y, count, cx, cy);
+    QVERIFY2(fuzzyEqual(radius, expected), qPrintable(QString("%1 != %2").arg(radius).arg(expected)));
+}
+
+void TestTouchPointKernels::covariance_data()
+{
+    addCounts();
+}
+
+void TestTouchPointKernels::covariance()
+{
+    QFETCH(int, count);
+
+    double cx, cy;
+    referenceCentroid(m_x, m_y, count, cx, cy);
+    double expectedXX = 0;
+    double expectedYY = 0;
+    double expectedXY = 0;
+    for (int i = 0; i < count; i++) {
+        expectedXX += (m_x[i] - cx) * (m_x[i] - cx);
+        expectedYY += (m_y[i] - cy) * (m_y[i] - cy);
+        expectedXY += (m_x[i] - cx) * (m_y[i] - cy);
+    }
+    expectedXX /= count;
+    expectedYY /= count;
+    expectedXY /= count;
+
+    float xx, yy, xy;
+    TouchPointKernels::covariance(m_x, m_y, count, cx, cy, xx, yy, xy);
+    QVERIFY2(fuzzyEqual(xx, expectedXX), qPrintable(QString("%1 != %2").arg(xx).arg(expectedXX)));
+    QVERIFY2(fuzzyEqual(yy, expectedYY), qPrintable(QString("%1 != %2").arg(yy).arg(expectedYY)));
+    QVERIFY2(fuzzyEqual(xy, expectedXY, expectedXX + expectedYY), qPrintable(QString("%1 != %2").arg(xy).arg(expectedXY)));
+}
+
+void TestTouchPointKernels::spread_data()
+{
+    addCounts();
+}
+
+void TestTouchPointKernels::spread()
+{
+    QFETCH(int, count);
+
+    double cx, cy;
+    referenceCentroid(m_x, m_y, count, cx, cy);
+    double sum = 0;
+    for (int i = 0; i < count; i++)
+        sum += (m_x[i] - cx) * (m_x[i] - cx) + (m_y[i] - cy) * (m_y[i] - cy);
+    double expected = 2 * std::sqrt(sum / count);
+
+    float spread = TouchPointKernels::spread(m_x, m_y, count);
+    QVERIFY2(fuzzyEqual(spread, expected), qPrintable(QString("%1 != %2").arg(spread).arg(expected)));
+
+    if (count == 2)
+        QVERIFY(fuzzyEqual(spread, std::hypot(m_x[1] - m_x[0], m_y[1] - m_y[0])));
+}
+
+void TestTouchPointKernels::rotation_data()
+{
+    addCounts();
+}
+
+void TestTouchPointKernels::rotation()
+{
+    QFETCH(int, count);
+
+    float angle = TouchPointKernels::rotation(m_x, m_y, m_rotatedX, m_rotatedY, count);
+    if (count == 1) {
+        // a single point has no rotation.
+        QCOMPARE(angle, 0.0f);
+        return;
+    }
+    QVERIFY2(fuzzyEqual(angle, rotation_angle), qPrintable(QString("%1 != %2").arg(angle).arg(rotation_angle)));
+
+    float reverse = TouchPointKernels::rotation(m_rotatedX, m_rotatedY, m_x, m_y, count);
+    QVERIFY(fuzzyEqual(reverse, -rotation_angle));
+}
+
+void TestTouchPointKernels::fixedSize()
+{
+    // the overloads of fixed size arrays must match the ones of a count.
+    float x[5], y[5], rotatedX[5], rotatedY[5];
+    for (int i = 0; i < 5; i++) {
+        x[i] = m_x[i];
+        y[i] = m_y[i];
+        rotatedX[i] = m_rotatedX[i];
+        rotatedY[i] = m_rotatedY[i];
+    }
+
+    float cx, cy, fixedX, fixedY;
+    TouchPointKernels::centroid(m_x, m_y, 5, cx, cy);
+    TouchPointKernels::centroid<5>(x, y, fixedX, fixedY);
+    QCOMPARE(fixedX, cx);
+    QCOMPARE(fixedY, cy);
+
+    QCOMPARE(TouchPointKernels::meanRadius<5>(x, y, cx, cy), TouchPointKernels::meanRadius(m_x, m_y, 5, cx, cy));
+    QCOMPARE(TouchPointKernels::spread<5>(x, y), TouchPointKernels::spread(m_x, m_y, 5));
+    QCOMPARE(TouchPointKernels::rotation<5>(x, y, rotatedX, rotatedY),
+             TouchPointKernels::rotation(m_x, m_y, m_rotatedX, m_rotatedY, 5));
+
+    float xx, yy, xy, fixedXX, fixedYY, fixedXY;
+    TouchPointKernels::covariance(m_x, m_y, 5, cx, cy, xx, yy, xy);
+    TouchPointKernels::covariance<5>(x, y, cx, cy, fixedXX, fixedYY, fixedXY);
+    QCOMPARE(fixedXX, xx);
+    QCOMPARE(fixedYY, yy);
+    QCOMPARE(fixedXY, xy);
+}
+
+QTEST_APPLESS_MAIN(TestTouchPointKernels)
+
+#include "tst-touch-point-kernels.moc"